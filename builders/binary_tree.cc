@@ -0,0 +1,158 @@
+#include "maze_algorithms.hh"
+#include "maze_random.hh"
+
+#include <cstdint>
+
+namespace Builder {
+
+namespace {
+
+enum class Opening
+{
+  none,
+  north,
+  east,
+};
+
+/* Every cell opens north or east on a coin flip. The top row can only open east and the last column
+ * only north so the north east corner is the root every cell leads to. A cell never looks at another
+ * so one 64 bit draw decides 64 cells.
+ */
+struct Binary_tree_row
+{
+  template<typename Carve>
+  void operator()( uint64_t cell_row, uint64_t cell_cols, Maze_random& gen, const Carve& carve ) const
+  {
+    uint64_t coins = 0;
+    for ( uint64_t cell = 0; cell < cell_cols; cell++ ) {
+      if ( cell % 64 == 0 ) {
+        coins = gen();
+      }
+      const bool last_col = cell + 1 == cell_cols;
+      if ( cell_row == 0 ) {
+        carve( cell, last_col ? Opening::none : Opening::east );
+      } else if ( last_col || ( ( coins >> ( cell % 64 ) ) & 1 ) ) {
+        carve( cell, Opening::north );
+      } else {
+        carve( cell, Opening::east );
+      }
+    }
+  }
+};
+
+/* A row is cut into runs of cells joined east, each ended by a coin flip, and every run opens north
+ * from one of its cells chosen at random. The top row is a single run with nowhere north to go. Runs
+ * only reach into the row above, which is already one tree, so no row waits on another.
+ */
+struct Sidewinder_row
+{
+  template<typename Carve>
+  void operator()( uint64_t cell_row, uint64_t cell_cols, Maze_random& gen, const Carve& carve ) const
+  {
+    uint64_t coins = 0;
+    uint64_t run_start = 0;
+    for ( uint64_t cell = 0; cell < cell_cols; cell++ ) {
+      if ( cell % 64 == 0 ) {
+        coins = gen();
+      }
+      const bool last_col = cell + 1 == cell_cols;
+      if ( cell_row == 0 ) {
+        carve( cell, last_col ? Opening::none : Opening::east );
+        continue;
+      }
+      if ( !last_col && ( ( coins >> ( cell % 64 ) ) & 1 ) ) {
+        carve( cell, Opening::east );
+        continue;
+      }
+      carve( run_start + gen.below( cell - run_start + 1 ), Opening::north );
+      run_start = cell + 1;
+    }
+  }
+};
+
+/* Each cell row owns the wall row above it so bands of rows never write the same square. Every row
+ * draws from its own stream so a seed gives the same maze on any number of cores. The wall glyphs
+ * need both neighbors of a band so they are drawn once every band is done.
+ */
+template<typename Row_builder>
+void generate_by_rows( Maze& maze, const Row_builder& build_row )
+{
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  const uint64_t seed = make_maze_random()();
+  for_each_slice( cell_rows, [&maze, &build_row, cell_rows, cell_cols, seed]( uint64_t first, uint64_t last ) {
+    const int64_t cols = maze.col_size();
+    for ( uint64_t cell_row = first; cell_row < last; cell_row++ ) {
+      const Maze::Row north_walls = maze[( 2 * cell_row )];
+      const Maze::Row cells = maze[( 2 * cell_row ) + 1];
+      for ( int64_t col = 0; col < cols; col++ ) {
+        north_walls[col] = 0;
+        cells[col] = col % 2 ? Maze::path_bit_ | Maze::builder_bit_ : Maze::Square { 0 };
+      }
+      if ( cell_row + 1 == cell_rows ) {
+        const Maze::Row south_walls = maze[( 2 * cell_row ) + 2];
+        for ( int64_t col = 0; col < cols; col++ ) {
+          south_walls[col] = 0;
+        }
+      }
+      Maze_random gen = make_maze_random( seed, cell_row );
+      build_row( cell_row, cell_cols, gen, [&north_walls, &cells]( uint64_t cell, Opening opening ) {
+        if ( opening == Opening::north ) {
+          north_walls[( 2 * cell ) + 1] = Maze::path_bit_ | Maze::builder_bit_;
+        } else if ( opening == Opening::east ) {
+          cells[( 2 * cell ) + 2] = Maze::path_bit_ | Maze::builder_bit_;
+        }
+      } );
+    }
+  } );
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ),
+                  [&maze]( uint64_t first, uint64_t last ) { rebuild_wall_lines( maze, first, last ); } );
+  clear_and_flush_grid( maze );
+}
+
+template<typename Row_builder>
+void animate_by_rows( Maze& maze, const Row_builder& build_row, Builder_speed speed )
+{
+  fill_maze_with_walls_animated( maze );
+  clear_and_flush_grid( maze );
+  const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  const uint64_t seed = make_maze_random()();
+  for ( uint64_t cell_row = 0; cell_row < cell_rows; cell_row++ ) {
+    const auto row = static_cast<int64_t>( ( 2 * cell_row ) + 1 );
+    Maze_random gen = make_maze_random( seed, cell_row );
+    build_row( cell_row, cell_cols, gen, [&maze, row, animation]( uint64_t cell, Opening opening ) {
+      const Maze::Point cur = { row, static_cast<int64_t>( ( 2 * cell ) + 1 ) };
+      if ( opening == Opening::north ) {
+        join_squares_animated( maze, cur, { cur.row - 2, cur.col }, animation );
+      } else if ( opening == Opening::east ) {
+        join_squares_animated( maze, cur, { cur.row, cur.col + 2 }, animation );
+      }
+    } );
+  }
+}
+
+} // namespace
+
+void generate_binary_tree_maze( Maze& maze )
+{
+  generate_by_rows( maze, Binary_tree_row {} );
+}
+
+void animate_binary_tree_maze( Maze& maze, Builder_speed speed )
+{
+  animate_by_rows( maze, Binary_tree_row {}, speed );
+}
+
+void generate_sidewinder_maze( Maze& maze )
+{
+  generate_by_rows( maze, Sidewinder_row {} );
+}
+
+void animate_sidewinder_maze( Maze& maze, Builder_speed speed )
+{
+  animate_by_rows( maze, Sidewinder_row {}, speed );
+}
+
+} // namespace Builder
@@ -0,0 +1,459 @@
+#include "disjoint_set.hh"
+#include "maze_algorithms.hh"
+#include "maze_random.hh"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace Builder {
+
+namespace {
+
+/* A life-like rule as two sets of neighbor counts. Bit k of birth means a dead square with k live
+ * neighbors comes alive and bit k of survive means a live one with k live neighbors stays alive.
+ * Live squares are walls.
+ */
+struct Life_rule
+{
+  uint16_t birth;
+  uint16_t survive;
+};
+
+// B3/S12345 and B3/S1234. Mazectric dies a little more readily and draws straighter halls.
+constexpr Life_rule maze_rule = { 0b1000, 0b111110 };
+constexpr Life_rule mazectric_rule = { 0b1000, 0b11110 };
+
+/* Large boards rarely stop outright. A few oscillators keep blinking so a run ends once the number
+ * of squares changing per generation has not set a new low, by at least a hundredth, for a while.
+ */
+constexpr uint64_t max_generations = 512;
+constexpr uint64_t settle_generations = 16;
+
+Life_rule life_rule( Automaton_rule rule )
+{
+  return rule == Automaton_rule::mazectric ? mazectric_rule : maze_rule;
+}
+
+/* One bit per square, 64 squares of a row to a word, in two boards so a generation reads one and
+ * writes the other. Each row has a dead word on both ends and a dead row sits above and below the
+ * board, so every neighbor word is a plain load. The eight neighbor bits of 64 squares at once are
+ * summed with a four bit counter kept as four words, one per binary digit, so a generation is a few
+ * dozen word operations per 64 squares and every row band is independent of the others.
+ */
+class Life_board
+{
+public:
+  Life_board( uint64_t rows, uint64_t cols )
+    : rows_( rows )
+    , cols_( cols )
+    , words_per_row_( ( cols + 63 ) / 64 )
+    , stride_( words_per_row_ + 2 )
+    , cur_( ( rows + 2 ) * stride_ )
+    , next_( ( rows + 2 ) * stride_ )
+  {
+  }
+
+  uint64_t rows() const
+  {
+    return rows_;
+  }
+
+  uint64_t cols() const
+  {
+    return cols_;
+  }
+
+  bool alive( uint64_t row, uint64_t col ) const
+  {
+    return ( row_words( cur_, row )[col / 64] >> ( col % 64 ) ) & 1;
+  }
+
+  void kill( uint64_t row, uint64_t col )
+  {
+    row_words( cur_, row )[col / 64] &= ~( uint64_t { 1 } << ( col % 64 ) );
+  }
+
+  // A random soup with about one square in four alive. The perimeter is always alive so it stays a wall.
+  void seed_rows( uint64_t first, uint64_t last, uint64_t seed )
+  {
+    for ( uint64_t row = first; row < last; row++ ) {
+      Maze_random gen = make_maze_random( seed, row );
+      uint64_t* words = row_words( cur_, row );
+      for ( uint64_t w = 0; w < words_per_row_; w++ ) {
+        words[w] = gen() & gen();
+      }
+      keep_perimeter( words, row );
+    }
+  }
+
+  // Writes the next generation of rows [first, last) and returns how many of their squares changed.
+  uint64_t step_rows( uint64_t first, uint64_t last, const Life_rule& rule )
+  {
+    uint64_t changed = 0;
+    for ( uint64_t row = first; row < last; row++ ) {
+      const uint64_t* above = row_words( cur_, row - 1 );
+      const uint64_t* here = row_words( cur_, row );
+      const uint64_t* below = row_words( cur_, row + 1 );
+      uint64_t* next = row_words( next_, row );
+      for ( uint64_t w = 0; w < words_per_row_; w++ ) {
+        std::array<uint64_t, 4> count {};
+        add( count, west( above, w ) );
+        add( count, above[w] );
+        add( count, east( above, w ) );
+        add( count, west( here, w ) );
+        add( count, east( here, w ) );
+        add( count, west( below, w ) );
+        add( count, below[w] );
+        add( count, east( below, w ) );
+        next[w] = ( ~here[w] & counts_in( count, rule.birth ) ) | ( here[w] & counts_in( count, rule.survive ) );
+      }
+      keep_perimeter( next, row );
+      for ( uint64_t w = 0; w < words_per_row_; w++ ) {
+        changed += static_cast<uint64_t>( std::popcount( next[w] ^ here[w] ) );
+      }
+    }
+    return changed;
+  }
+
+  void swap_generations()
+  {
+    cur_.swap( next_ );
+  }
+
+private:
+  uint64_t rows_;
+  uint64_t cols_;
+  uint64_t words_per_row_;
+  uint64_t stride_;
+  std::vector<uint64_t> cur_;
+  std::vector<uint64_t> next_;
+
+  // Row -1 wraps to the largest unsigned value and lands on the dead row above the board.
+  uint64_t* row_words( std::vector<uint64_t>& board, uint64_t row ) const
+  {
+    return &board[( ( row + 1 ) * stride_ ) + 1];
+  }
+
+  const uint64_t* row_words( const std::vector<uint64_t>& board, uint64_t row ) const
+  {
+    return &board[( ( row + 1 ) * stride_ ) + 1];
+  }
+
+  // Every square lined up with its west neighbor, carrying in the top bit of the word before.
+  static uint64_t west( const uint64_t* words, uint64_t w )
+  {
+    return ( words[w] << 1 ) | ( words[w - 1] >> 63 );
+  }
+
+  static uint64_t east( const uint64_t* words, uint64_t w )
+  {
+    return ( words[w] >> 1 ) | ( words[w + 1] << 63 );
+  }
+
+  // Adds one bit to each of 64 bit sliced counters. Eight neighbors never overflow four digits.
+  static void add( std::array<uint64_t, 4>& count, uint64_t bits )
+  {
+    for ( uint64_t& digit : count ) {
+      const uint64_t carry = digit & bits;
+      digit ^= bits;
+      bits = carry;
+    }
+  }
+
+  // The squares whose count is one of the counts set in the mask.
+  static uint64_t counts_in( const std::array<uint64_t, 4>& count, uint16_t mask )
+  {
+    uint64_t result = 0;
+    for ( uint16_t k = 0; k <= 8; k++ ) {
+      if ( !( mask & ( 1U << k ) ) ) {
+        continue;
+      }
+      uint64_t equal = ~uint64_t { 0 };
+      for ( uint16_t digit = 0; digit < count.size(); digit++ ) {
+        equal &= ( k >> digit ) & 1U ? count[digit] : ~count[digit];
+      }
+      result |= equal;
+    }
+    return result;
+  }
+
+  // Padding bits past the last column stay dead so they never count as neighbors.
+  void keep_perimeter( uint64_t* words, uint64_t row ) const
+  {
+    if ( row == 0 || row + 1 == rows_ ) {
+      for ( uint64_t w = 0; w < words_per_row_; w++ ) {
+        words[w] = ~uint64_t { 0 };
+      }
+    }
+    words[0] |= 1;
+    words[( cols_ - 1 ) / 64] |= uint64_t { 1 } << ( ( cols_ - 1 ) % 64 );
+    if ( cols_ % 64 ) {
+      words[words_per_row_ - 1] &= ( uint64_t { 1 } << ( cols_ % 64 ) ) - 1;
+    }
+  }
+};
+
+// Runs one generation on every core and returns how many squares changed.
+uint64_t step_generation( Life_board& board, const Life_rule& rule )
+{
+  std::atomic<uint64_t> changed { 0 };
+  for_each_slice( board.rows(), [&board, &rule, &changed]( uint64_t first, uint64_t last ) {
+    changed.fetch_add( board.step_rows( first, last, rule ), std::memory_order_relaxed );
+  } );
+  board.swap_generations();
+  return changed.load();
+}
+
+// Steps the board until it settles and calls the callback after every generation.
+template<typename On_generation>
+void run_until_settled( Life_board& board, const Life_rule& rule, const On_generation& on_generation )
+{
+  uint64_t fewest_changes = std::numeric_limits<uint64_t>::max();
+  uint64_t generations_since_fewest = 0;
+  for ( uint64_t generation = 0; generation < max_generations && generations_since_fewest < settle_generations;
+        generation++ ) {
+    const uint64_t changed = step_generation( board, rule );
+    on_generation();
+    if ( changed == 0 ) {
+      return;
+    }
+    if ( changed < fewest_changes - ( fewest_changes / 100 ) ) {
+      fewest_changes = changed;
+      generations_since_fewest = 0;
+    } else {
+      generations_since_fewest++;
+    }
+  }
+}
+
+/* The dead squares of a settled board as pockets in a union-find. A wall square is opened when it
+ * joins two pockets and then belongs to them, so pockets only ever grow together.
+ */
+class Pockets
+{
+public:
+  explicit Pockets( Life_board& board )
+    : board_( board ), sets_( board.rows() * board.cols() ), met_( board.rows() * board.cols(), false )
+  {
+    for ( uint64_t row = 1; row + 1 < board_.rows(); row++ ) {
+      for ( uint64_t col = 1; col + 1 < board_.cols(); col++ ) {
+        if ( board_.alive( row, col ) ) {
+          continue;
+        }
+        if ( !board_.alive( row - 1, col ) ) {
+          sets_.made_union( id( row, col ), id( row - 1, col ) );
+        }
+        if ( !board_.alive( row, col - 1 ) ) {
+          sets_.made_union( id( row, col ), id( row, col - 1 ) );
+        }
+      }
+    }
+  }
+
+  bool is_open( uint64_t row, uint64_t col ) const
+  {
+    return !board_.alive( row, col );
+  }
+
+  bool same_pocket( uint64_t a_row, uint64_t a_col, uint64_t b_row, uint64_t b_col )
+  {
+    return sets_.find( id( a_row, a_col ) ) == sets_.find( id( b_row, b_col ) );
+  }
+
+  void open( uint64_t row, uint64_t col )
+  {
+    board_.kill( row, col );
+    for ( const Maze::Point& d : Maze::cardinal_directions_ ) {
+      const uint64_t next_row = row + static_cast<uint64_t>( d.row );
+      const uint64_t next_col = col + static_cast<uint64_t>( d.col );
+      if ( !board_.alive( next_row, next_col ) ) {
+        sets_.made_union( id( row, col ), id( next_row, next_col ) );
+      }
+    }
+  }
+
+  // True only the first time any square of a pocket is asked about.
+  bool is_first_meeting( uint64_t row, uint64_t col )
+  {
+    const uint64_t root = sets_.find( id( row, col ) );
+    if ( met_[root] ) {
+      return false;
+    }
+    met_[root] = true;
+    return true;
+  }
+
+  // Pockets merged after a meeting are marked under their new root so they are never met again.
+  void remember_meeting( uint64_t row, uint64_t col )
+  {
+    met_[sets_.find( id( row, col ) )] = true;
+  }
+
+private:
+  Life_board& board_;
+  Disjoint_set sets_;
+  std::vector<bool> met_;
+
+  uint64_t id( uint64_t row, uint64_t col ) const
+  {
+    return ( row * board_.cols() ) + col;
+  }
+};
+
+/* Carves from the top left square of a pocket to a square met earlier in row order, north first and
+ * then along the row. Every square on the way lies in rows and columns between the two so the
+ * perimeter is never touched, and the tunnel stops at the first square of another pocket.
+ */
+void tunnel( Pockets& pockets, const Maze::Point& from, const Maze::Point& to )
+{
+  const auto from_row = static_cast<uint64_t>( from.row );
+  const auto from_col = static_cast<uint64_t>( from.col );
+  const auto to_row = static_cast<uint64_t>( to.row );
+  const auto to_col = static_cast<uint64_t>( to.col );
+  uint64_t row = from_row;
+  uint64_t col = from_col;
+  const auto reached_another = [&pockets, from_row, from_col, &row, &col] {
+    if ( pockets.is_open( row, col ) && !pockets.same_pocket( row, col, from_row, from_col ) ) {
+      pockets.open( row, col );
+      return true;
+    }
+    pockets.open( row, col );
+    return false;
+  };
+  while ( row > to_row ) {
+    row--;
+    if ( reached_another() ) {
+      return;
+    }
+  }
+  while ( col != to_col ) {
+    col = col < to_col ? col + 1 : col - 1;
+    if ( reached_another() ) {
+      return;
+    }
+  }
+}
+
+/* A settled soup leaves thousands of pockets sealed off from each other, so solvers would rarely
+ * find a way between two random squares. First every wall square one thick between two pockets is
+ * opened, which joins most of them with a single gap each. The pockets that remain are each tunneled
+ * to the pocket met just before them in row order.
+ */
+void join_pockets( Life_board& board )
+{
+  Pockets pockets( board );
+  for ( uint64_t row = 1; row + 1 < board.rows(); row++ ) {
+    for ( uint64_t col = 1; col + 1 < board.cols(); col++ ) {
+      if ( !board.alive( row, col ) ) {
+        continue;
+      }
+      const bool splits_north_south = pockets.is_open( row - 1, col ) && pockets.is_open( row + 1, col )
+                                      && !pockets.same_pocket( row - 1, col, row + 1, col );
+      const bool splits_west_east = pockets.is_open( row, col - 1 ) && pockets.is_open( row, col + 1 )
+                                    && !pockets.same_pocket( row, col - 1, row, col + 1 );
+      if ( splits_north_south || splits_west_east ) {
+        pockets.open( row, col );
+      }
+    }
+  }
+  std::optional<Maze::Point> last_met {};
+  for ( uint64_t row = 1; row + 1 < board.rows(); row++ ) {
+    for ( uint64_t col = 1; col + 1 < board.cols(); col++ ) {
+      // The first square of a pocket in row order has walls north and west, or they would come first.
+      if ( board.alive( row, col ) || !board.alive( row - 1, col ) || !board.alive( row, col - 1 )
+           || !pockets.is_first_meeting( row, col ) ) {
+        continue;
+      }
+      const Maze::Point here = { static_cast<int64_t>( row ), static_cast<int64_t>( col ) };
+      if ( last_met ) {
+        tunnel( pockets, here, last_met.value() );
+        pockets.remember_meeting( row, col );
+      }
+      last_met = here;
+    }
+  }
+}
+
+/* The single pass from bits to squares. A dead square is a path and a live one is a wall whose glyph
+ * reaches toward its live neighbors. Only the board is read so row bands need not wait on each other.
+ */
+void draw_board( Maze& maze, const Life_board& board )
+{
+  const auto rows = static_cast<uint64_t>( maze.row_size() );
+  const auto cols = static_cast<uint64_t>( maze.col_size() );
+  for_each_slice( rows, [&maze, &board, rows, cols]( uint64_t first, uint64_t last ) {
+    for ( uint64_t row = first; row < last; row++ ) {
+      const Maze::Row squares = maze[row];
+      for ( uint64_t col = 0; col < cols; col++ ) {
+        if ( !board.alive( row, col ) ) {
+          squares[col] = Maze::path_bit_ | Maze::builder_bit_;
+          continue;
+        }
+        Maze::Wall_line wall = 0b0;
+        if ( row > 0 && board.alive( row - 1, col ) ) {
+          wall |= Maze::north_wall_;
+        }
+        if ( col + 1 < cols && board.alive( row, col + 1 ) ) {
+          wall |= Maze::east_wall_;
+        }
+        if ( row + 1 < rows && board.alive( row + 1, col ) ) {
+          wall |= Maze::south_wall_;
+        }
+        if ( col > 0 && board.alive( row, col - 1 ) ) {
+          wall |= Maze::west_wall_;
+        }
+        squares[col] = wall;
+      }
+    }
+  } );
+}
+
+Life_board seeded_board( const Maze& maze )
+{
+  Life_board board( static_cast<uint64_t>( maze.row_size() ), static_cast<uint64_t>( maze.col_size() ) );
+  const uint64_t seed = make_maze_random()();
+  for_each_slice( board.rows(),
+                  [&board, seed]( uint64_t first, uint64_t last ) { board.seed_rows( first, last, seed ); } );
+  return board;
+}
+
+} // namespace
+
+/* The halls are not a perfect maze. Loops are common, but after the pockets are joined every open
+ * square reaches every other. Every square is decided by the board so nothing of the old maze survives.
+ */
+void generate_cellular_automaton_maze( Maze& maze, Automaton_rule rule )
+{
+  const Life_rule life = life_rule( rule );
+  Life_board board = seeded_board( maze );
+  run_until_settled( board, life, [] {} );
+  join_pockets( board );
+  draw_board( maze, board );
+  clear_and_flush_grid( maze );
+}
+
+void animate_cellular_automaton_maze( Maze& maze, Automaton_rule rule, Builder_speed speed )
+{
+  const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
+  const Life_rule life = life_rule( rule );
+  Life_board board = seeded_board( maze );
+  draw_board( maze, board );
+  clear_and_flush_grid( maze );
+  run_until_settled( board, life, [&maze, &board, animation] {
+    draw_board( maze, board );
+    clear_and_flush_grid( maze );
+    std::this_thread::sleep_for( std::chrono::microseconds( animation ) );
+  } );
+  join_pockets( board );
+  draw_board( maze, board );
+  clear_and_flush_grid( maze );
+}
+
+} // namespace Builder
@@ -1,137 +1,329 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <numeric>
-#include <random>
-#include <unordered_map>
+#include <ostream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace Builder {
 
 namespace {
 
-using Set_id = int;
+constexpr int horizontal_bias = 2;
+
+using Passage_row = std::vector<uint8_t>;
 
-struct Sliding_set_window
+/* Eller's algorithm in cell space one row at a time. The sets of the current row are a union-find
+ * forest over the columns so a horizontal merge is a near constant time link instead of a rescan
+ * of the row. The sets are then counting sorted by root so every set chooses its own drops from a
+ * contiguous run of columns. Dropped columns seed the next row with one of their own as the root
+ * and every other column starts fresh as its own set, so set ids never outgrow the row width.
+ * Every buffer is sized once up front and each row is O(width) with no allocation.
+ */
+class Eller_rows
 {
-  uint64_t curr_row { 0 };
-  std::vector<std::vector<Set_id>> sets;
-  explicit Sliding_set_window( const Maze& maze ) : sets( 2, std::vector<Set_id>( maze.col_size(), { 0 } ) ) {}
+public:
+  explicit Eller_rows( uint64_t cell_cols )
+    : gen_( make_maze_random() )
+    , parent_( cell_cols )
+    , next_parent_( cell_cols )
+    , roots_( cell_cols )
+    , set_start_( cell_cols + 1 )
+    , members_( cell_cols )
+    , fill_cursor_( cell_cols )
+  {
+    std::iota( begin( parent_ ), end( parent_ ), 0 );
+  }
+
+  // Decides the east passages of the current row and which cells drop south into the next one.
+  void next_row( Passage_row& east, Passage_row& south )
+  {
+    const uint64_t cols = parent_.size();
+    std::fill( begin( east ), end( east ), 0 );
+    std::fill( begin( south ), end( south ), 0 );
+    for ( uint64_t col = 0; col + 1 < cols; col++ ) {
+      const uint64_t left = find( col );
+      const uint64_t right = find( col + 1 );
+      if ( left != right && gen_.below( horizontal_bias + 1 ) ) {
+        east[col] = 1;
+        parent_[right] = left;
+      }
+    }
+
+    group_by_set();
+    std::iota( begin( next_parent_ ), end( next_parent_ ), 0 );
+    for ( uint64_t root = 0; root < cols; root++ ) {
+      const uint64_t first = set_start_[root];
+      const uint64_t last = set_start_[root + 1];
+      if ( first == last ) {
+        continue;
+      }
+      const uint64_t drops = 1 + gen_.below( last - first );
+      uint64_t next_root = cols;
+      for ( uint64_t drop = 0; drop < drops; drop++ ) {
+        const uint64_t chosen = members_[first + gen_.below( last - first )];
+        if ( south[chosen] ) {
+          continue;
+        }
+        south[chosen] = 1;
+        if ( next_root == cols ) {
+          next_root = chosen;
+        }
+        next_parent_[chosen] = next_root;
+      }
+    }
+    std::swap( parent_, next_parent_ );
+  }
+
+  // The last row joins every set that is still apart so the maze is one tree.
+  void final_row( Passage_row& east )
+  {
+    std::fill( begin( east ), end( east ), 0 );
+    for ( uint64_t col = 0; col + 1 < parent_.size(); col++ ) {
+      const uint64_t left = find( col );
+      const uint64_t right = find( col + 1 );
+      if ( left != right ) {
+        east[col] = 1;
+        parent_[right] = left;
+      }
+    }
+  }
+
+private:
+  Maze_random gen_;
+  std::vector<uint64_t> parent_;
+  std::vector<uint64_t> next_parent_;
+  std::vector<uint64_t> roots_;
+  // Members of the set rooted at r are members_[set_start_[r]] up to members_[set_start_[r + 1]].
+  std::vector<uint64_t> set_start_;
+  std::vector<uint64_t> members_;
+  std::vector<uint64_t> fill_cursor_;
+
+  uint64_t find( uint64_t col )
+  {
+    while ( parent_[col] != col ) {
+      parent_[col] = parent_[parent_[col]];
+      col = parent_[col];
+    }
+    return col;
+  }
+
+  void group_by_set()
+  {
+    const uint64_t cols = parent_.size();
+    std::fill( begin( set_start_ ), end( set_start_ ), 0 );
+    for ( uint64_t col = 0; col < cols; col++ ) {
+      roots_[col] = find( col );
+      set_start_[roots_[col] + 1]++;
+    }
+    std::partial_sum( begin( set_start_ ), end( set_start_ ), begin( set_start_ ) );
+    std::copy( begin( set_start_ ), end( set_start_ ) - 1, begin( fill_cursor_ ) );
+    for ( uint64_t col = 0; col < cols; col++ ) {
+      members_[fill_cursor_[roots_[col]]++] = col;
+    }
+  }
 };
 
-struct Id_merge_request
+/* Square rows are written as soon as they can be drawn. A wall glyph depends on the rows above and
+ * below so text output holds back one row and keeps a window of three. Binary output needs no
+ * neighbors and writes every row as it arrives.
+ */
+class Square_row_writer
 {
-  Set_id winning_id;
-  Set_id losing_id;
-};
+public:
+  Square_row_writer( std::ostream& out, const Stream_args& args )
+    : out_( out ), args_( args ), window_( 3, Passage_row( args.odd_cols, 0 ) ), buffered_( 0 ), bytes_ {}
+  {
+    if ( args_.format == Stream_format::binary ) {
+      out_.write( stream_magic_.data(), stream_magic_.size() );
+      out_.write( reinterpret_cast<const char*>( &args_.odd_cols ), sizeof( args_.odd_cols ) );
+    }
+  }
 
-constexpr int horizontal_bias = 2;
+  // The row is the path bit of every square.
+  void push( const Passage_row& row )
+  {
+    if ( args_.format == Stream_format::binary ) {
+      write_binary( row );
+      return;
+    }
+    window_[buffered_ % window_.size()] = row;
+    buffered_++;
+    if ( buffered_ >= 2 ) {
+      write_text( buffered_ - 2, true );
+    }
+  }
 
-void merge_sets( Sliding_set_window& sets, const Id_merge_request& merge, int col_in_row )
-{
-  for ( uint64_t set_elem = col_in_row + 2; set_elem < sets.sets[0].size() - 1; set_elem += 2 ) {
-    if ( sets.sets[sets.curr_row][set_elem] == merge.losing_id ) {
-      sets.sets[sets.curr_row][set_elem] = merge.winning_id;
+  void finish()
+  {
+    if ( args_.format == Stream_format::text && buffered_ ) {
+      write_text( buffered_ - 1, false );
     }
+    out_.flush();
+  }
+
+private:
+  static constexpr std::array<char, 8> stream_magic_ = { 'M', 'A', 'Z', 'E', 'S', 'T', 'R', '1' };
+
+  std::ostream& out_;
+  Stream_args args_;
+  std::vector<Passage_row> window_;
+  uint64_t buffered_;
+  std::string bytes_;
+
+  bool is_wall( uint64_t row, int64_t col ) const
+  {
+    return col >= 0 && static_cast<uint64_t>( col ) < args_.odd_cols
+           && !window_[row % window_.size()][static_cast<uint64_t>( col )];
   }
-  for ( int set_elem = col_in_row - 2; set_elem > 0; set_elem -= 2 ) {
-    if ( sets.sets[sets.curr_row][set_elem] == merge.losing_id ) {
-      sets.sets[sets.curr_row][set_elem] = merge.winning_id;
+
+  void write_text( uint64_t row, bool has_below )
+  {
+    const std::array<std::string_view, 16>& walls = Maze::wall_styles_.at( static_cast<uint64_t>( args_.style ) );
+    bytes_.clear();
+    for ( int64_t col = 0; col < static_cast<int64_t>( args_.odd_cols ); col++ ) {
+      if ( !is_wall( row, col ) ) {
+        bytes_ += ' ';
+        continue;
+      }
+      Maze::Wall_line wall = 0b0;
+      if ( row > 0 && is_wall( row - 1, col ) ) {
+        wall |= Maze::north_wall_;
+      }
+      if ( is_wall( row, col + 1 ) ) {
+        wall |= Maze::east_wall_;
+      }
+      if ( has_below && is_wall( row + 1, col ) ) {
+        wall |= Maze::south_wall_;
+      }
+      if ( is_wall( row, col - 1 ) ) {
+        wall |= Maze::west_wall_;
+      }
+      bytes_ += walls.at( wall );
     }
+    bytes_ += '\n';
+    out_ << bytes_;
   }
-}
 
-void complete_final_row( Maze& maze, Sliding_set_window& window )
+  void write_binary( const Passage_row& row )
+  {
+    bytes_.assign( ( row.size() + 7 ) / 8, '\0' );
+    for ( uint64_t col = 0; col < row.size(); col++ ) {
+      if ( row[col] ) {
+        bytes_[col / 8] = static_cast<char>( bytes_[col / 8] | ( 1 << ( col % 8 ) ) );
+      }
+    }
+    out_.write( bytes_.data(), static_cast<std::streamsize>( bytes_.size() ) );
+  }
+};
+
+} // namespace
+
+/* The compact version writes the cell space rows straight into the passages. Squares are never
+ * materialized so the only memory besides the passages is O(width).
+ */
+void generate_compact_eller_maze( Passage_maze& maze )
 {
-  const int final_row = maze.row_size() - 2;
-  for ( int col = 1; col < maze.col_size() - 2; col += 2 ) {
-    const Maze::Point next = { final_row, col + 2 };
-    const Set_id this_square_id = window.sets[window.curr_row][col];
-    if ( this_square_id != window.sets[window.curr_row][col + 2] ) {
-      join_squares( maze, { final_row, col }, next );
-      const Set_id other_set_id = window.sets[window.curr_row][next.col];
-      for ( int set_elem = next.col; set_elem < maze.col_size() - 1; set_elem += 2 ) {
-        if ( window.sets[window.curr_row][set_elem] == other_set_id ) {
-          window.sets[window.curr_row][set_elem] = this_square_id;
-        }
+  Eller_rows rows( maze.cell_cols() );
+  Passage_row east( maze.cell_cols() );
+  Passage_row south( maze.cell_cols() );
+  for ( uint64_t row = 0; row + 1 < maze.cell_rows(); row++ ) {
+    rows.next_row( east, south );
+    for ( uint64_t col = 0; col < maze.cell_cols(); col++ ) {
+      if ( east[col] ) {
+        maze.open_east( { row, col } );
+      }
+      if ( south[col] ) {
+        maze.open_south( { row, col } );
       }
     }
   }
+  rows.final_row( east );
+  for ( uint64_t col = 0; col < maze.cell_cols(); col++ ) {
+    if ( east[col] ) {
+      maze.open_east( { maze.cell_rows() - 1, col } );
+    }
+  }
 }
 
-void complete_final_row_animated( Maze& maze, Sliding_set_window& window, Speed_unit animation )
+void stream_eller_maze( std::ostream& out, const Stream_args& args )
 {
-  const int final_row = maze.row_size() - 2;
-  for ( int col = 1; col < maze.col_size() - 2; col += 2 ) {
-    const Maze::Point next = { final_row, col + 2 };
-    const Set_id this_square_id = window.sets[window.curr_row][col];
-    if ( this_square_id != window.sets[window.curr_row][col + 2] ) {
-      join_squares_animated( maze, { final_row, col }, next, animation );
-      const Set_id other_set_id = window.sets[window.curr_row][next.col];
-      for ( int set_elem = next.col; set_elem < maze.col_size() - 1; set_elem += 2 ) {
-        if ( window.sets[window.curr_row][set_elem] == other_set_id ) {
-          window.sets[window.curr_row][set_elem] = this_square_id;
-        }
+  const uint64_t cell_cols = ( args.odd_cols - 1 ) / 2;
+  const uint64_t cell_rows = ( args.odd_rows - 1 ) / 2;
+  Eller_rows rows( cell_cols );
+  Square_row_writer writer( out, args );
+  Passage_row east( cell_cols );
+  Passage_row south( cell_cols );
+  Passage_row squares( args.odd_cols, 0 );
+  writer.push( squares );
+  for ( uint64_t row = 0; args.odd_rows == 0 || row < cell_rows; row++ ) {
+    const bool last = args.odd_rows != 0 && row + 1 == cell_rows;
+    if ( last ) {
+      rows.final_row( east );
+    } else {
+      rows.next_row( east, south );
+    }
+    std::fill( begin( squares ), end( squares ), 0 );
+    for ( uint64_t col = 0; col < cell_cols; col++ ) {
+      squares[( 2 * col ) + 1] = 1;
+      squares[( 2 * col ) + 2] = east[col];
+    }
+    writer.push( squares );
+    std::fill( begin( squares ), end( squares ), 0 );
+    if ( !last ) {
+      for ( uint64_t col = 0; col < cell_cols; col++ ) {
+        squares[( 2 * col ) + 1] = south[col];
       }
     }
+    writer.push( squares );
+    if ( !out ) {
+      return;
+    }
   }
+  writer.finish();
 }
 
-} // namespace
-
 /* There are two fun details about this implementation: the auxillary memory requirement is a constant determined
  * by the width of a row and the randomness is thorough when determining how many squares per set should drop below.
- * The downside is the way I am doing it now is somewhat slow. I want to keep the memory footprint low and a good
- * randomized technique to choose dropping squares. Find a better strategy.
+ * The rows are decided in cell space by the same engine the compact and streaming builders use and then carved
+ * into the squares, so each row costs O(width) however wide the maze is.
  */
 
 void generate_eller_maze( Maze& maze )
 {
   fill_maze_with_walls( maze );
-  std::mt19937 gen( std::random_device {}() );
-  std::uniform_int_distribution<int> coin( 0, horizontal_bias );
-
-  Sliding_set_window window( maze );
-  std::iota( std::begin( window.sets[0] ), std::end( window.sets[0] ), 0 );
-  Set_id unique_ids = maze.col_size();
-  std::unordered_map<Set_id, std::vector<Maze::Point>> sets_in_this_row {};
-  for ( int row = 1; row < maze.row_size() - 2; row += 2 ) {
-    const uint64_t next_row = ( window.curr_row + 1 ) % window.sets.size();
-    std::iota( std::begin( window.sets[next_row] ), std::end( window.sets[next_row] ), unique_ids );
-    unique_ids += maze.col_size();
-
-    for ( int col = 1; col < maze.col_size() - 1; col += 2 ) {
-      const Maze::Point next = { row, col + 2 };
-      const Set_id this_square_id = window.sets[window.curr_row][col];
-      if ( is_square_within_perimeter_walls( maze, next )
-           && this_square_id != window.sets[window.curr_row][next.col] && coin( gen ) ) {
-        join_squares( maze, { row, col }, next );
-        merge_sets( window, { this_square_id, window.sets[window.curr_row][next.col] }, col );
+  const uint64_t cell_cols = ( maze.col_size() - 1 ) / 2;
+  Eller_rows rows( cell_cols );
+  Passage_row east( cell_cols );
+  Passage_row south( cell_cols );
+  for ( int64_t row = 1; row < maze.row_size() - 1; row += 2 ) {
+    const bool last = row + 2 >= maze.row_size() - 1;
+    if ( last ) {
+      rows.final_row( east );
+    } else {
+      rows.next_row( east, south );
+    }
+    for ( uint64_t cell = 0; cell < cell_cols; cell++ ) {
+      const Maze::Point cur = { row, static_cast<int64_t>( ( 2 * cell ) + 1 ) };
+      if ( east[cell] ) {
+        join_squares( maze, cur, { cur.row, cur.col + 2 } );
       }
     }
-
-    for ( int col = 1; col < maze.col_size() - 1; col += 2 ) {
-      const Set_id this_square_id = window.sets[window.curr_row][col];
-      sets_in_this_row[this_square_id].push_back( { row, col } );
+    if ( last ) {
+      break;
     }
-
-    for ( const auto& s : sets_in_this_row ) {
-      std::uniform_int_distribution<uint64_t> num_drops( 1, s.second.size() );
-      const uint64_t drops = num_drops( gen );
-      for ( uint64_t drop = 0; drop < drops; drop++ ) {
-        std::uniform_int_distribution<uint64_t> rand_drop( 0, s.second.size() - 1 );
-        const Maze::Point chosen = s.second[rand_drop( gen )];
-        // We already linked this up and rondomness dropped us here again. More important for animated version.
-        if ( !( maze[chosen.row + 2][chosen.col] & Maze::builder_bit_ ) ) {
-          window.sets[next_row][chosen.col] = s.first;
-          join_squares( maze, chosen, { chosen.row + 2, chosen.col } );
-        }
+    for ( uint64_t cell = 0; cell < cell_cols; cell++ ) {
+      const Maze::Point cur = { row, static_cast<int64_t>( ( 2 * cell ) + 1 ) };
+      if ( south[cell] ) {
+        join_squares( maze, cur, { cur.row + 2, cur.col } );
       }
     }
-    window.curr_row = next_row;
-    sets_in_this_row.clear();
   }
-  complete_final_row( maze, window );
   clear_and_flush_grid( maze );
 }
 
@@ -140,50 +332,33 @@ void animate_eller_maze( Maze& maze, Builder_speed speed )
   fill_maze_with_walls_animated( maze );
   clear_and_flush_grid( maze );
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
-  std::mt19937 gen( std::random_device {}() );
-  std::uniform_int_distribution<int> coin( 0, horizontal_bias );
-
-  Sliding_set_window window( maze );
-  std::iota( std::begin( window.sets[0] ), std::end( window.sets[0] ), 0 );
-  Set_id unique_ids = maze.col_size();
-  std::unordered_map<Set_id, std::vector<Maze::Point>> sets_in_this_row {};
-  for ( int row = 1; row < maze.row_size() - 2; row += 2 ) {
-    const uint64_t next_row = ( window.curr_row + 1 ) % window.sets.size();
-    std::iota( std::begin( window.sets[next_row] ), std::end( window.sets[next_row] ), unique_ids );
-    unique_ids += maze.col_size();
-
-    for ( int col = 1; col < maze.col_size() - 1; col += 2 ) {
-      const Maze::Point next = { row, col + 2 };
-      const Set_id this_square_id = window.sets[window.curr_row][col];
-      if ( is_square_within_perimeter_walls( maze, next )
-           && this_square_id != window.sets[window.curr_row][next.col] && coin( gen ) ) {
-        join_squares_animated( maze, { row, col }, next, animation );
-        merge_sets( window, { this_square_id, window.sets[window.curr_row][next.col] }, col );
+  const uint64_t cell_cols = ( maze.col_size() - 1 ) / 2;
+  Eller_rows rows( cell_cols );
+  Passage_row east( cell_cols );
+  Passage_row south( cell_cols );
+  for ( int64_t row = 1; row < maze.row_size() - 1; row += 2 ) {
+    const bool last = row + 2 >= maze.row_size() - 1;
+    if ( last ) {
+      rows.final_row( east );
+    } else {
+      rows.next_row( east, south );
+    }
+    for ( uint64_t cell = 0; cell < cell_cols; cell++ ) {
+      const Maze::Point cur = { row, static_cast<int64_t>( ( 2 * cell ) + 1 ) };
+      if ( east[cell] ) {
+        join_squares_animated( maze, cur, { cur.row, cur.col + 2 }, animation );
       }
     }
-
-    for ( int col = 1; col < maze.col_size() - 1; col += 2 ) {
-      const Set_id this_square_id = window.sets[window.curr_row][col];
-      sets_in_this_row[this_square_id].push_back( { row, col } );
+    if ( last ) {
+      break;
     }
-
-    for ( const auto& s : sets_in_this_row ) {
-      std::uniform_int_distribution<uint64_t> num_drops( 1, s.second.size() );
-      const uint64_t drops = num_drops( gen );
-      for ( uint64_t drop = 0; drop < drops; drop++ ) {
-        std::uniform_int_distribution<uint64_t> rand_drop( 0, s.second.size() - 1 );
-        const Maze::Point chosen = s.second[rand_drop( gen )];
-        // We already linked this up and rondomness dropped us here again. Save pointless cursor movements.
-        if ( !( maze[chosen.row + 2][chosen.col] & Maze::builder_bit_ ) ) {
-          window.sets[next_row][chosen.col] = s.first;
-          join_squares_animated( maze, chosen, { chosen.row + 2, chosen.col }, animation );
-        }
+    for ( uint64_t cell = 0; cell < cell_cols; cell++ ) {
+      const Maze::Point cur = { row, static_cast<int64_t>( ( 2 * cell ) + 1 ) };
+      if ( south[cell] ) {
+        join_squares_animated( maze, cur, { cur.row + 2, cur.col }, animation );
       }
     }
-    window.curr_row = next_row;
-    sets_in_this_row.clear();
   }
-  complete_final_row_animated( maze, window, animation );
 }
 
 } // namespace Builder
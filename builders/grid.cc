@@ -1,8 +1,9 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
 #include <algorithm>
 #include <chrono>
-#include <random>
+#include <numeric>
 #include <stack>
 #include <thread>
 
@@ -53,16 +54,14 @@ void animate_run( Maze& maze, std::stack<Maze::Point>& dfs, Run_start run, Speed
 void generate_grid_maze( Maze& maze )
 {
   fill_maze_with_walls( maze );
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution row_random( 1, maze.row_size() - 2 );
-  std::uniform_int_distribution col_random( 1, maze.col_size() - 2 );
-  std::stack<Maze::Point> dfs(
-    { { 2 * ( row_random( generator ) / 2 ) + 1, 2 * ( col_random( generator ) / 2 ) + 1 } } );
+  Maze_random generator = make_maze_random();
+  std::stack<Maze::Point> dfs( { { ( 2 * ( generator.between( 1, maze.row_size() - 2 ) / 2 ) ) + 1,
+                                  ( 2 * ( generator.between( 1, maze.col_size() - 2 ) / 2 ) ) + 1 } } );
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
   while ( !dfs.empty() ) {
     const Maze::Point cur = dfs.top();
-    std::shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     bool branches_remain = false;
     for ( const int& i : random_direction_indices ) {
       const Maze::Point& direction = Maze::generate_directions_.at( i );
@@ -85,16 +84,14 @@ void animate_grid_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
   fill_maze_with_walls_animated( maze );
   clear_and_flush_grid( maze );
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution row_random( 1, maze.row_size() - 2 );
-  std::uniform_int_distribution col_random( 1, maze.col_size() - 2 );
-  std::stack<Maze::Point> dfs(
-    { { 2 * ( row_random( generator ) / 2 ) + 1, 2 * ( col_random( generator ) / 2 ) + 1 } } );
+  Maze_random generator = make_maze_random();
+  std::stack<Maze::Point> dfs( { { ( 2 * ( generator.between( 1, maze.row_size() - 2 ) / 2 ) ) + 1,
+                                  ( 2 * ( generator.between( 1, maze.col_size() - 2 ) / 2 ) ) + 1 } } );
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
   while ( !dfs.empty() ) {
     const Maze::Point cur = dfs.top();
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     bool branches_remain = false;
     for ( const int& i : random_direction_indices ) {
       const Maze::Point& direction = Maze::generate_directions_.at( i );
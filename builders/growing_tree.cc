@@ -0,0 +1,201 @@
+#include "maze_algorithms.hh"
+#include "maze_random.hh"
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace Builder {
+
+namespace {
+
+/* The cells a growing tree may still grow from, oldest first. The buffer is a power of two so the
+ * ring wraps with a mask and it only ever doubles, so memory follows the largest the frontier gets
+ * rather than the size of the maze. Cells are stored as 32 bit indices whenever the maze allows it.
+ */
+template<typename Cell_id>
+class Frontier_ring
+{
+public:
+  constexpr Frontier_ring() : cells_( initial_capacity_ ), mask_( initial_capacity_ - 1 ) {}
+
+  constexpr bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  constexpr uint64_t size() const
+  {
+    return size_;
+  }
+
+  // Index zero is the oldest cell and size() - 1 the newest.
+  constexpr Cell_id operator[]( uint64_t i ) const
+  {
+    return cells_[( head_ + i ) & mask_];
+  }
+
+  constexpr void push_back( Cell_id cell )
+  {
+    if ( size_ == cells_.size() ) {
+      grow();
+    }
+    cells_[( head_ + size_ ) & mask_] = cell;
+    size_++;
+  }
+
+  /* The newest cell retires by shrinking the ring so the newest policy pops a stack. Any other hole is
+   * filled by the oldest cell, which keeps removal constant time and never disturbs the newest end.
+   */
+  constexpr void remove( uint64_t i )
+  {
+    if ( i + 1 == size_ ) {
+      size_--;
+      return;
+    }
+    cells_[( head_ + i ) & mask_] = cells_[head_];
+    head_ = ( head_ + 1 ) & mask_;
+    size_--;
+  }
+
+private:
+  static constexpr uint64_t initial_capacity_ = 64;
+  std::vector<Cell_id> cells_;
+  uint64_t mask_;
+  uint64_t head_ { 0 };
+  uint64_t size_ { 0 };
+
+  constexpr void grow()
+  {
+    std::vector<Cell_id> bigger( cells_.size() * 2 );
+    for ( uint64_t i = 0; i < size_; i++ ) {
+      bigger[i] = ( *this )[i];
+    }
+    cells_.swap( bigger );
+    mask_ = cells_.size() - 1;
+    head_ = 0;
+  }
+};
+
+/* Doubles the ring once, retires the oldest half so the head moves, and pushes until the newest end
+ * wraps around the buffer. Each pop of the newest cell must then be the last push still waiting.
+ */
+constexpr bool newest_frontier_is_a_stack()
+{
+  constexpr uint32_t first_pushes = 200;
+  constexpr uint32_t oldest_retired = 100;
+  constexpr uint32_t last_cell = 350;
+  Frontier_ring<uint32_t> frontier;
+  for ( uint32_t cell = 0; cell < first_pushes; cell++ ) {
+    frontier.push_back( cell );
+  }
+  for ( uint32_t i = 0; i < oldest_retired; i++ ) {
+    frontier.remove( 0 );
+  }
+  for ( uint32_t cell = first_pushes; cell < last_cell; cell++ ) {
+    frontier.push_back( cell );
+  }
+  for ( uint32_t expected = last_cell; expected-- > oldest_retired; ) {
+    if ( frontier[frontier.size() - 1] != expected ) {
+      return false;
+    }
+    frontier.remove( frontier.size() - 1 );
+  }
+  return frontier.empty();
+}
+
+static_assert( newest_frontier_is_a_stack(), "the newest policy must grow from the last cell it pushed" );
+
+uint64_t choose_cell( Growing_tree_policy policy, uint64_t frontier_size, Maze_random& gen )
+{
+  switch ( policy ) {
+    case Growing_tree_policy::newest:
+      return frontier_size - 1;
+    case Growing_tree_policy::oldest:
+      return 0;
+    case Growing_tree_policy::random:
+      return gen.below( frontier_size );
+    default:
+      return gen.bits( 1 ) ? frontier_size - 1 : gen.below( frontier_size );
+  }
+}
+
+/* Grows one tree from a random cell. Each step picks a frontier cell by the policy and joins it to a
+ * random unvisited neighbor, which joins the frontier, or retires it once it has none. Newest walks
+ * like a depth first search and keeps its work in a few hot cache lines, oldest spreads like a breadth
+ * first search with long straight halls, and random looks like Prim's.
+ */
+template<typename Cell_id, typename Join>
+void grow_tree( Maze& maze, Growing_tree_policy policy, const Join& join )
+{
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  const auto to_point = [cell_cols]( uint64_t cell ) -> Maze::Point {
+    return { static_cast<int64_t>( ( 2 * ( cell / cell_cols ) ) + 1 ),
+             static_cast<int64_t>( ( 2 * ( cell % cell_cols ) ) + 1 ) };
+  };
+  Maze_random gen = make_maze_random();
+  std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
+  std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
+  Frontier_ring<Cell_id> frontier;
+  const uint64_t start = gen.below( cell_rows * cell_cols );
+  const Maze::Point start_point = to_point( start );
+  maze[start_point.row][start_point.col] |= Maze::builder_bit_;
+  frontier.push_back( static_cast<Cell_id>( start ) );
+  while ( !frontier.empty() ) {
+    const uint64_t i = choose_cell( policy, frontier.size(), gen );
+    const uint64_t cell = frontier[i];
+    const Maze::Point cur = to_point( cell );
+    gen.shuffle( random_direction_indices );
+    bool branches_remain = false;
+    for ( const int& d : random_direction_indices ) {
+      const Maze::Point& direction = Maze::generate_directions_.at( d );
+      const Maze::Point next = { cur.row + direction.row, cur.col + direction.col };
+      if ( can_build_new_square( maze, next ) ) {
+        join( cur, next );
+        frontier.push_back( static_cast<Cell_id>( ( ( next.row / 2 ) * cell_cols ) + ( next.col / 2 ) ) );
+        branches_remain = true;
+        break;
+      }
+    }
+    if ( !branches_remain ) {
+      frontier.remove( i );
+    }
+  }
+}
+
+template<typename Join>
+void grow_tree( Maze& maze, Growing_tree_policy policy, const Join& join )
+{
+  const auto cells = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 )
+                     * static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  if ( cells <= std::numeric_limits<uint32_t>::max() ) {
+    grow_tree<uint32_t>( maze, policy, join );
+  } else {
+    grow_tree<uint64_t>( maze, policy, join );
+  }
+}
+
+} // namespace
+
+void generate_growing_tree_maze( Maze& maze, Growing_tree_policy policy )
+{
+  fill_maze_with_walls( maze );
+  grow_tree( maze, policy, [&maze]( const Maze::Point& cur, const Maze::Point& next ) {
+    join_squares( maze, cur, next );
+  } );
+  clear_and_flush_grid( maze );
+}
+
+void animate_growing_tree_maze( Maze& maze, Growing_tree_policy policy, Builder_speed speed )
+{
+  const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
+  fill_maze_with_walls_animated( maze );
+  clear_and_flush_grid( maze );
+  grow_tree( maze, policy, [&maze, animation]( const Maze::Point& cur, const Maze::Point& next ) {
+    join_squares_animated( maze, cur, next, animation );
+  } );
+}
+
+} // namespace Builder
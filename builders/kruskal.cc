@@ -1,74 +1,221 @@
 #include "disjoint_set.hh"
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <random>
+#include <cstdint>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 namespace Builder {
 
 namespace {
 
-std::vector<Maze::Point> load_shuffled_walls( Maze& maze )
+/* Walls are numbered instead of stored. Every cell with an east neighbor owns east wall number
+ * row * ( cell_cols - 1 ) + col and every cell with a south neighbor owns south wall number
+ * east_walls + row * cell_cols + col. Cell ids are the row major index of a cell, so both cells of
+ * a wall come from its number with a divide and no lookup table.
+ */
+struct Wall
 {
-  std::vector<Maze::Point> walls = {};
-  // The walls between cells to the left and right. If row is odd look left and right.
-  for ( int row = 1; row < maze.row_size() - 1; row += 2 ) {
-    // Cells will be odd walls will be even within a col.
-    for ( int col = 2; col < maze.col_size() - 1; col += 2 ) {
-      walls.push_back( { row, col } );
+  Maze::Point square;
+  Maze::Point first_cell;
+  Maze::Point second_cell;
+  uint64_t first_id;
+  uint64_t second_id;
+};
+
+struct Wall_numbering
+{
+  uint64_t cell_cols;
+  uint64_t east_walls;
+  uint64_t wall_count;
+};
+
+Wall_numbering wall_numbering( uint64_t cell_rows, uint64_t cell_cols )
+{
+  const uint64_t east_walls = cell_rows * ( cell_cols - 1 );
+  return { cell_cols, east_walls, east_walls + ( ( cell_rows - 1 ) * cell_cols ) };
+}
+
+Wall_numbering wall_numbering( const Maze& maze )
+{
+  return wall_numbering( static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 ),
+                         static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 ) );
+}
+
+Wall wall_at( const Wall_numbering& walls, uint64_t number )
+{
+  if ( number < walls.east_walls ) {
+    const auto row = static_cast<int64_t>( number / ( walls.cell_cols - 1 ) );
+    const auto col = static_cast<int64_t>( number % ( walls.cell_cols - 1 ) );
+    const uint64_t id = ( static_cast<uint64_t>( row ) * walls.cell_cols ) + static_cast<uint64_t>( col );
+    return { { ( 2 * row ) + 1, ( 2 * col ) + 2 },
+             { ( 2 * row ) + 1, ( 2 * col ) + 1 },
+             { ( 2 * row ) + 1, ( 2 * col ) + 3 },
+             id,
+             id + 1 };
+  }
+  const uint64_t south = number - walls.east_walls;
+  const auto row = static_cast<int64_t>( south / walls.cell_cols );
+  const auto col = static_cast<int64_t>( south % walls.cell_cols );
+  return { { ( 2 * row ) + 2, ( 2 * col ) + 1 },
+           { ( 2 * row ) + 1, ( 2 * col ) + 1 },
+           { ( 2 * row ) + 3, ( 2 * col ) + 1 },
+           south,
+           south + walls.cell_cols };
+}
+
+/* A random order of the wall numbers without a shuffled list. A balanced Feistel network is a
+ * bijection on the smallest even bit width that covers every number, and any output past the last
+ * wall is encrypted again until it lands in range. Walking a permutation of [0, n) this way visits
+ * every number exactly once and the domain is never more than four times n so a lookup takes only a
+ * few rounds on average. The state is four round keys no matter how large the maze is.
+ */
+class Wall_permutation
+{
+public:
+  Wall_permutation( uint64_t count, Maze_random& generator )
+    : count_( count ), half_bits_( half_bits_for( count ) ), half_mask_( ( uint64_t { 1 } << half_bits_ ) - 1 )
+  {
+    for ( uint64_t& key : keys_ ) {
+      key = generator();
     }
   }
-  // The walls between cells above and below. If row is even look above and below.
-  for ( int row = 2; row < maze.row_size() - 1; row += 2 ) {
-    for ( int col = 1; col < maze.col_size() - 1; col += 2 ) {
-      walls.push_back( { row, col } );
+
+  uint64_t operator()( uint64_t index ) const
+  {
+    uint64_t permuted = encrypt( index );
+    while ( permuted >= count_ ) {
+      permuted = encrypt( permuted );
     }
+    return permuted;
   }
-  std::shuffle( walls.begin(), walls.end(), std::mt19937( std::random_device {}() ) );
-  return walls;
-}
 
-std::unordered_map<Maze::Point, int> tag_cells( Maze& maze )
-{
-  std::unordered_map<Maze::Point, int> set_ids = {};
-  int id = 0;
-  for ( int row = 1; row < maze.row_size() - 1; row += 2 ) {
-    // Cells will be odd walls will be even within a col.
-    for ( int col = 1; col < maze.col_size() - 1; col += 2 ) {
-      set_ids[{ row, col }] = id;
-      id++;
+  uint64_t size() const
+  {
+    return count_;
+  }
+
+private:
+  static constexpr uint64_t rounds_ = 4;
+  uint64_t count_;
+  uint64_t half_bits_;
+  uint64_t half_mask_;
+  std::array<uint64_t, rounds_> keys_ {};
+
+  static uint64_t half_bits_for( uint64_t count )
+  {
+    uint64_t half = 1;
+    while ( half < 32 && ( uint64_t { 1 } << ( 2 * half ) ) < count ) {
+      half++;
+    }
+    return half;
+  }
+
+  // The splitmix64 finalizer keyed by the round key.
+  static uint64_t round_function( uint64_t half, uint64_t key )
+  {
+    half ^= key;
+    half = ( half ^ ( half >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    half = ( half ^ ( half >> 27 ) ) * 0x94d049bb133111ebULL;
+    return half ^ ( half >> 31 );
+  }
+
+  uint64_t encrypt( uint64_t block ) const
+  {
+    uint64_t left = block >> half_bits_;
+    uint64_t right = block & half_mask_;
+    for ( const uint64_t key : keys_ ) {
+      const uint64_t next = left ^ ( round_function( right, key ) & half_mask_ );
+      left = right;
+      right = next;
     }
+    return ( left << half_bits_ ) | right;
   }
-  return set_ids;
+};
+
+Wall_permutation random_wall_order( uint64_t count )
+{
+  Maze_random generator = make_maze_random();
+  return Wall_permutation( count, generator );
+}
+
+uint64_t cell_count( const Maze& maze )
+{
+  return static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 )
+         * static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
 }
 
 } // namespace
 
+void generate_compact_kruskal_maze( Passage_maze& maze )
+{
+  const Wall_numbering numbering = wall_numbering( maze.cell_rows(), maze.cell_cols() );
+  const Wall_permutation order = random_wall_order( numbering.wall_count );
+  Disjoint_set sets( maze.cell_rows() * maze.cell_cols() );
+  for ( uint64_t i = 0; i < order.size(); i++ ) {
+    const Wall wall = wall_at( numbering, order( i ) );
+    if ( !sets.made_union( wall.first_id, wall.second_id ) ) {
+      continue;
+    }
+    const Passage_maze::Cell cell
+      = { static_cast<uint64_t>( wall.first_cell.row / 2 ), static_cast<uint64_t>( wall.first_cell.col / 2 ) };
+    if ( wall.first_cell.row == wall.second_cell.row ) {
+      maze.open_east( cell );
+    } else {
+      maze.open_south( cell );
+    }
+  }
+}
+
 void generate_kruskal_maze( Maze& maze )
 {
   fill_maze_with_walls( maze );
-  const std::vector<Maze::Point> walls = load_shuffled_walls( maze );
-  const std::unordered_map<Maze::Point, int> set_ids = tag_cells( maze );
-  Disjoint_set sets( set_ids.size() );
-  for ( const Maze::Point& p : walls ) {
-    if ( p.row % 2 == 0 ) {
-      const Maze::Point above_cell = { p.row - 1, p.col };
-      const Maze::Point below_cell = { p.row + 1, p.col };
-      if ( sets.made_union( set_ids.at( above_cell ), set_ids.at( below_cell ) ) ) {
-        join_squares( maze, above_cell, below_cell );
+  const Wall_numbering numbering = wall_numbering( maze );
+  const Wall_permutation order = random_wall_order( numbering.wall_count );
+  Disjoint_set sets( cell_count( maze ) );
+  for ( uint64_t i = 0; i < order.size(); i++ ) {
+    const Wall wall = wall_at( numbering, order( i ) );
+    if ( sets.made_union( wall.first_id, wall.second_id ) ) {
+      join_squares( maze, wall.first_cell, wall.second_cell );
+    }
+  }
+  clear_and_flush_grid( maze );
+}
+
+/* Every thread takes a slice of the wall order and unions through a lock-free disjoint set. A
+ * union has exactly one winner so each wall is opened by at most one thread and the tree is still
+ * perfect. Threads only ever write the wall squares they own during the unions. Wall lines are drawn
+ * afterwards from the finished path bits, again split by rows, where neighbors are read atomically
+ * because a neighbor row may belong to another thread.
+ */
+void generate_parallel_kruskal_maze( Maze& maze )
+{
+  const auto rows = static_cast<uint64_t>( maze.row_size() );
+  const auto cols = maze.col_size();
+  for_each_slice( rows, [&maze, cols]( uint64_t first, uint64_t last ) {
+    for ( uint64_t row = first; row < last; row++ ) {
+      for ( int64_t col = 0; col < cols; col++ ) {
+        maze[row][col] = row % 2 && col % 2 ? Maze::path_bit_ | Maze::builder_bit_ : Maze::Square { 0 };
       }
-    } else {
-      const Maze::Point left_cell = { p.row, p.col - 1 };
-      const Maze::Point right_cell = { p.row, p.col + 1 };
-      if ( sets.made_union( set_ids.at( left_cell ), set_ids.at( right_cell ) ) ) {
-        join_squares( maze, left_cell, right_cell );
+    }
+  } );
+  const Wall_numbering numbering = wall_numbering( maze );
+  const Wall_permutation order = random_wall_order( numbering.wall_count );
+  Concurrent_disjoint_set sets( cell_count( maze ) );
+  for_each_slice( order.size(), [&maze, &numbering, &order, &sets]( uint64_t first, uint64_t last ) {
+    for ( uint64_t i = first; i < last; i++ ) {
+      const Wall wall = wall_at( numbering, order( i ) );
+      if ( sets.made_union( wall.first_id, wall.second_id ) ) {
+        maze[wall.square.row][wall.square.col] = Maze::path_bit_ | Maze::builder_bit_;
       }
     }
-  }
+  } );
+  for_each_slice( rows, [&maze]( uint64_t first, uint64_t last ) { rebuild_wall_lines( maze, first, last ); } );
   clear_and_flush_grid( maze );
 }
 
@@ -77,23 +224,13 @@ void animate_kruskal_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
   fill_maze_with_walls_animated( maze );
   clear_and_flush_grid( maze );
-  const std::vector<Maze::Point> walls = load_shuffled_walls( maze );
-  const std::unordered_map<Maze::Point, int> set_ids = tag_cells( maze );
-  Disjoint_set sets( set_ids.size() );
-
-  for ( const Maze::Point& p : walls ) {
-    if ( p.row % 2 == 0 ) {
-      const Maze::Point above_cell = { p.row - 1, p.col };
-      const Maze::Point below_cell = { p.row + 1, p.col };
-      if ( sets.made_union( set_ids.at( above_cell ), set_ids.at( below_cell ) ) ) {
-        join_squares_animated( maze, above_cell, below_cell, animation );
-      }
-    } else {
-      const Maze::Point left_cell = { p.row, p.col - 1 };
-      const Maze::Point right_cell = { p.row, p.col + 1 };
-      if ( sets.made_union( set_ids.at( left_cell ), set_ids.at( right_cell ) ) ) {
-        join_squares_animated( maze, left_cell, right_cell, animation );
-      }
+  const Wall_numbering numbering = wall_numbering( maze );
+  const Wall_permutation order = random_wall_order( numbering.wall_count );
+  Disjoint_set sets( cell_count( maze ) );
+  for ( uint64_t i = 0; i < order.size(); i++ ) {
+    const Wall wall = wall_at( numbering, order( i ) );
+    if ( sets.made_union( wall.first_id, wall.second_id ) ) {
+      join_squares_animated( maze, wall.first_cell, wall.second_cell, animation );
     }
   }
 }
@@ -0,0 +1,206 @@
+#include "living_maze.hh"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace Builder {
+
+namespace {
+
+// Index 0 of backtracking_marks_ is the origin and 1 through 4 are north, east, south, and west.
+constexpr uint64_t first_direction = 1;
+constexpr uint64_t direction_count = 4;
+
+uint64_t opposite( uint64_t direction )
+{
+  return ( ( direction + 1 ) % direction_count ) + 1;
+}
+
+Maze::Backtrack_marker mark( uint64_t direction )
+{
+  return static_cast<Maze::Backtrack_marker>( direction << Maze::marker_shift_ );
+}
+
+uint64_t parent_direction( const Maze& maze, const Maze::Point& cell )
+{
+  return static_cast<uint64_t>( ( maze[cell.row][cell.col] & Maze::markers_mask_ ) >> Maze::marker_shift_ );
+}
+
+Maze::Point step( const Maze::Point& cell, uint64_t direction )
+{
+  const Maze::Point& d = Maze::backtracking_marks_.at( direction );
+  return { cell.row + d.row, cell.col + d.col };
+}
+
+Maze::Point wall_between( const Maze::Point& a, const Maze::Point& b )
+{
+  return { ( a.row + b.row ) / 2, ( a.col + b.col ) / 2 };
+}
+
+bool is_path( const Maze& maze, const Maze::Point& p )
+{
+  return maze[p.row][p.col] & Maze::path_bit_;
+}
+
+void set_parent( Maze& maze, const Maze::Point& cell, uint64_t direction )
+{
+  maze[cell.row][cell.col] &= static_cast<Maze::Square>( ~Maze::markers_mask_ );
+  maze[cell.row][cell.col] |= mark( direction );
+}
+
+Maze::Point random_path_cell( const Maze& maze, Maze_random& gen )
+{
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  const Maze::Point choice = { static_cast<int64_t>( ( 2 * gen.below( cell_rows ) ) + 1 ),
+                               static_cast<int64_t>( ( 2 * gen.below( cell_cols ) ) + 1 ) };
+  if ( is_path( maze, choice ) ) {
+    return choice;
+  }
+  // Only a builder that walls over cells, like the automaton, can land here.
+  for ( int64_t row = 1; row < maze.row_size() - 1; row += 2 ) {
+    for ( int64_t col = 1; col < maze.col_size() - 1; col += 2 ) {
+      if ( is_path( maze, { row, col } ) ) {
+        return { row, col };
+      }
+    }
+  }
+  return choice;
+}
+
+void clear_marks( Maze& maze )
+{
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ), [&maze]( uint64_t first, uint64_t last ) {
+    const int64_t cols = maze.col_size();
+    for ( uint64_t row = first; row < last; row++ ) {
+      const Maze::Row squares = maze[row];
+      for ( int64_t col = 0; col < cols; col++ ) {
+        squares[col] &= static_cast<Maze::Square>( ~Maze::markers_mask_ );
+      }
+    }
+  } );
+}
+
+} // namespace
+
+/* A depth first walk that keeps its stack in the marks it writes. A cell joins the tree by marking
+ * the way back to the cell it was reached from, and once a cell has no unmarked open neighbor the
+ * walk follows that mark back. Each cell is entered once and returned to at most four times.
+ */
+Living_maze::Living_maze( Maze& maze ) : maze_( maze ), gen_( make_maze_random() ), origin_()
+{
+  clear_marks( maze_ );
+  origin_ = random_path_cell( maze_, gen_ );
+  if ( !is_path( maze_, origin_ ) ) {
+    return;
+  }
+  Maze::Point cur = origin_;
+  for ( ;; ) {
+    bool branched = false;
+    for ( uint64_t d = first_direction; d <= direction_count; d++ ) {
+      const Maze::Point next = step( cur, d );
+      if ( is_square_within_perimeter_walls( maze_, next ) && is_path( maze_, wall_between( cur, next ) )
+           && is_path( maze_, next ) && next != origin_ && !parent_direction( maze_, next ) ) {
+        set_parent( maze_, next, opposite( d ) );
+        cur = next;
+        branched = true;
+        break;
+      }
+    }
+    if ( branched ) {
+      continue;
+    }
+    if ( cur == origin_ ) {
+      return;
+    }
+    cur = step( cur, parent_direction( maze_, cur ) );
+  }
+}
+
+Living_maze::~Living_maze()
+{
+  clear_marks( maze_ );
+}
+
+/* The origin only moves to neighbors in its tree, which every cell has a mark for. Cells the first
+ * walk never reached, such as the sealed pockets of an automaton maze, are never touched.
+ */
+template<typename Redraw>
+void Living_maze::shift_with( const Redraw& redraw )
+{
+  std::array<uint64_t, direction_count> choices {};
+  uint64_t count = 0;
+  for ( uint64_t d = first_direction; d <= direction_count; d++ ) {
+    const Maze::Point next = step( origin_, d );
+    if ( is_square_within_perimeter_walls( maze_, next ) && parent_direction( maze_, next ) ) {
+      choices.at( count++ ) = d;
+    }
+  }
+  if ( count == 0 ) {
+    return;
+  }
+  const uint64_t d = choices.at( gen_.below( count ) );
+  const Maze::Point next = step( origin_, d );
+  const Maze::Point parent = step( next, parent_direction( maze_, next ) );
+  set_parent( maze_, origin_, d );
+  maze_[next.row][next.col] &= static_cast<Maze::Square>( ~Maze::markers_mask_ );
+  // A child of the origin keeps the same edge with the arrow turned around.
+  if ( parent != origin_ ) {
+    const Maze::Point opened = wall_between( origin_, next );
+    build_path( maze_, opened );
+    redraw( opened );
+    const Maze::Point closed = wall_between( next, parent );
+    maze_[closed.row][closed.col] &= static_cast<Maze::Square>( ~Maze::wall_mask_ );
+    build_wall_carefully( maze_, closed );
+    redraw( closed );
+  }
+  origin_ = next;
+}
+
+void Living_maze::shift()
+{
+  shift_with( []( const Maze::Point& ) {} );
+}
+
+void Living_maze::shift_animated( Speed_unit speed )
+{
+  shift_with( [this, speed]( const Maze::Point& wall ) {
+    for ( const Maze::Point& offset : Maze::cardinal_directions_ ) {
+      const Maze::Point p = { wall.row + offset.row, wall.col + offset.col };
+      if ( !is_path( maze_, p ) ) {
+        flush_cursor_maze_coordinate( maze_, p );
+      }
+    }
+    flush_cursor_maze_coordinate( maze_, wall );
+    std::this_thread::sleep_for( std::chrono::microseconds( speed ) );
+  } );
+}
+
+const Maze::Point& Living_maze::origin() const
+{
+  return origin_;
+}
+
+void evolve_maze( Maze& maze, uint64_t shifts )
+{
+  {
+    Living_maze living( maze );
+    for ( uint64_t i = 0; i < shifts; i++ ) {
+      living.shift();
+    }
+  }
+  clear_and_flush_grid( maze );
+}
+
+void evolve_maze_animated( Maze& maze, uint64_t shifts, Builder_speed speed )
+{
+  const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
+  Living_maze living( maze );
+  for ( uint64_t i = 0; i < shifts; i++ ) {
+    living.shift_animated( animation );
+  }
+}
+
+} // namespace Builder
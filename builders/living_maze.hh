@@ -0,0 +1,58 @@
+#pragma once
+#ifndef LIVING_MAZE_HH
+#define LIVING_MAZE_HH
+#include "maze.hh"
+#include "maze_random.hh"
+#include "maze_utilities.hh"
+
+#include <cstdint>
+
+namespace Builder {
+
+/* Keeps a finished maze changing in place with origin shift steps. The maze is read as a tree whose
+ * root is the origin, and every other cell stores the direction to its parent in its backtrack marker
+ * bits, the same from_north_ through from_west_ marks the backtracking builders leave behind.
+ *
+ *   before           after one shift east
+ *   ┌───┬───────┐    ┌───────┬───┐   The origin O points at a random neighbor N, the wall
+ *   │ O │ N ← P │    │ O → N │ P │   between N and its old parent P is closed, and N is the
+ *   └───┴───────┘    └───────┴───┘   new origin. Every cell still reaches the origin.
+ *
+ * A perfect maze stays perfect after every shift and a shift rewrites only the two wall squares it
+ * opens and closes along with the marks of the old and new origin. Walls that no tree edge crosses,
+ * such as the extra openings of a modification, are left as they are. The solvers paint over the
+ * marker bits so they are cleared again when this is destroyed, and nothing may solve the maze while
+ * one is alive.
+ */
+class Living_maze
+{
+public:
+  // Roots the tree at a random path cell with one stackless walk over every cell it can reach.
+  explicit Living_maze( Maze& maze );
+  ~Living_maze();
+  Living_maze( const Living_maze& ) = delete;
+  Living_maze& operator=( const Living_maze& ) = delete;
+  Living_maze( Living_maze&& ) = delete;
+  Living_maze& operator=( Living_maze&& ) = delete;
+
+  void shift();
+  // Redraws only the wall squares a shift changed. The arrows of the marks are never printed.
+  void shift_animated( Speed_unit speed );
+  const Maze::Point& origin() const;
+
+private:
+  Maze& maze_;
+  Maze_random gen_;
+  Maze::Point origin_;
+
+  template<typename Redraw>
+  void shift_with( const Redraw& redraw );
+};
+
+// Runs a number of origin shifts on a finished maze and clears the marks they leave.
+void evolve_maze( Maze& maze, uint64_t shifts );
+void evolve_maze_animated( Maze& maze, uint64_t shifts, Builder_speed speed );
+
+} // namespace Builder
+
+#endif
@@ -2,6 +2,11 @@
 #ifndef MAZE_ALGORITHMS_HH
 #define MAZE_ALGORITHMS_HH
 #include "maze_utilities.hh"
+#include "passage_maze.hh"
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
 
 namespace Builder {
 
@@ -10,15 +15,21 @@ void animate_recursive_backtracker_maze( Maze& maze, Builder_speed speed );
 
 void generate_recursive_subdivision_maze( Maze& maze );
 void animate_recursive_subdivision_maze( Maze& maze, Builder_speed speed );
+// Chambers above a size cutoff are tasks for a work stealing pool on every core.
+void generate_parallel_recursive_subdivision_maze( Maze& maze );
 
 void generate_wilson_path_carver_maze( Maze& maze );
 void animate_wilson_path_carver_maze( Maze& maze, Builder_speed speed );
 
 void generate_wilson_wall_adder_maze( Maze& maze );
 void animate_wilson_wall_adder_maze( Maze& maze, Builder_speed speed );
+// A uniform spanning tree like Wilson's from many Wilson walks at once, one per core.
+void generate_cycle_popping_wilson_maze( Maze& maze );
 
 void generate_kruskal_maze( Maze& maze );
 void animate_kruskal_maze( Maze& maze, Builder_speed speed );
+// Unions the shuffled walls on every core. Animation is the serial builder since one cursor draws it.
+void generate_parallel_kruskal_maze( Maze& maze );
 
 void generate_prim_maze( Maze& maze );
 void animate_prim_maze( Maze& maze, Builder_speed speed );
@@ -26,12 +37,86 @@ void animate_prim_maze( Maze& maze, Builder_speed speed );
 void generate_eller_maze( Maze& maze );
 void animate_eller_maze( Maze& maze, Builder_speed speed );
 
+// Hunts for the next walk with word wide tests over a visited bitmap that starts at the lowest open row.
+void generate_hunt_and_kill_maze( Maze& maze );
+void animate_hunt_and_kill_maze( Maze& maze, Builder_speed speed );
+
+/* The policy picks which frontier cell grows next. Mix takes the newest half the time and a random
+ * one otherwise. Memory is the frontier alone, a ring of cell indices, on top of the maze.
+ */
+enum class Growing_tree_policy
+{
+  newest,
+  oldest,
+  random,
+  mix,
+};
+void generate_growing_tree_maze( Maze& maze, Growing_tree_policy policy );
+void animate_growing_tree_maze( Maze& maze, Growing_tree_policy policy, Builder_speed speed );
+
+// Every row is decided on its own so bands of rows are built on every core. Animation draws one row at a time.
+void generate_binary_tree_maze( Maze& maze );
+void animate_binary_tree_maze( Maze& maze, Builder_speed speed );
+
+void generate_sidewinder_maze( Maze& maze );
+void animate_sidewinder_maze( Maze& maze, Builder_speed speed );
+
+/* Life-like rules over one bit per square, stepped on every core until the board settles. Maze is
+ * B3/S12345 and Mazectric B3/S1234. Halls are one square wide, may loop, and may leave pockets cut off.
+ */
+enum class Automaton_rule
+{
+  maze,
+  mazectric,
+};
+void generate_cellular_automaton_maze( Maze& maze, Automaton_rule rule );
+void animate_cellular_automaton_maze( Maze& maze, Automaton_rule rule, Builder_speed speed );
+
 void generate_grid_maze( Maze& maze );
 void animate_grid_maze( Maze& maze, Builder_speed speed );
 
 void generate_arena( Maze& maze );
 void animate_arena( Maze& maze, Builder_speed speed );
 
+/* Splits the maze into about threads rectangular tiles, runs the builder on every tile in its own
+ * thread, and opens one door per edge of a random spanning tree over the tiles. Any perfect builder
+ * gives a perfect maze.
+ */
+using Tile_builder = std::function<void( Maze& )>;
+void generate_tiled_maze( Maze& maze, const Tile_builder& builder, uint64_t threads );
+
+/* Compact builders write straight into two bits per cell. They never touch a square grid so they
+ * are the builders to reach for when the full Maze would not fit in memory.
+ */
+void generate_compact_recursive_backtracker_maze( Passage_maze& maze );
+// The same seed always carves the same maze. Maze_world relies on this to rebuild evicted chunks.
+void generate_compact_recursive_backtracker_maze( Passage_maze& maze, uint64_t seed );
+void generate_compact_kruskal_maze( Passage_maze& maze );
+void generate_compact_eller_maze( Passage_maze& maze );
+
+enum class Stream_format
+{
+  text,
+  binary,
+};
+
+/* Rows of zero never stop. Text is the same wall glyphs a Maze prints. Binary starts with the
+ * eight byte magic MAZESTR1 and the column count as a 64 bit integer, then every square row is one
+ * path bit per square packed low bit first into whole bytes.
+ */
+struct Stream_args
+{
+  uint64_t odd_rows = 0;
+  uint64_t odd_cols = 111;
+  Maze::Maze_style style = Maze::Maze_style::sharp;
+  Stream_format format = Stream_format::text;
+};
+
+/* Writes each row of an Eller maze as soon as it is decided. Only O(width) memory is ever held so
+ * the height may be unbounded.
+ */
+void stream_eller_maze( std::ostream& out, const Stream_args& args );
+
 } // namespace Builder
 
 #endif
@@ -0,0 +1,213 @@
+#include "maze_world.hh"
+#include "maze_algorithms.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Builder {
+
+namespace {
+
+// The splitmix64 finalizer. Neighboring chunk coordinates land on unrelated seeds.
+uint64_t mix( uint64_t x )
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+  x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+  return x ^ ( x >> 31 );
+}
+
+uint64_t chunk_seed( uint64_t seed, int64_t row, int64_t col )
+{
+  return mix( mix( mix( seed ) ^ static_cast<uint64_t>( row ) ) ^ static_cast<uint64_t>( col ) );
+}
+
+int64_t floor_div( int64_t n, int64_t d )
+{
+  return n >= 0 ? n / d : -( ( -n + d - 1 ) / d );
+}
+
+int64_t floor_mod( int64_t n, int64_t d )
+{
+  return n - ( floor_div( n, d ) * d );
+}
+
+/* Walls over every path square outside the largest region the window connects on its own. Regions
+ * of the world may only join through squares the window cuts off, so without this a solver could
+ * place its start and finish where no path inside the window links them.
+ */
+void keep_largest_region( Maze& window )
+{
+  const int64_t rows = window.row_size();
+  const int64_t cols = window.col_size();
+  constexpr uint64_t unlabeled = std::numeric_limits<uint64_t>::max();
+  std::vector<uint64_t> region( static_cast<uint64_t>( rows * cols ), unlabeled );
+  const auto id = [cols]( const Maze::Point& p ) { return static_cast<uint64_t>( ( p.row * cols ) + p.col ); };
+  std::vector<uint64_t> region_sizes;
+  std::vector<Maze::Point> flood;
+  for ( int64_t row = 0; row < rows; row++ ) {
+    for ( int64_t col = 0; col < cols; col++ ) {
+      if ( !( window[row][col] & Maze::path_bit_ ) || region[id( { row, col } )] != unlabeled ) {
+        continue;
+      }
+      const uint64_t label = region_sizes.size();
+      region_sizes.push_back( 0 );
+      region[id( { row, col } )] = label;
+      flood.push_back( { row, col } );
+      while ( !flood.empty() ) {
+        const Maze::Point cur = flood.back();
+        flood.pop_back();
+        region_sizes.back()++;
+        // The outer ring is always wall so a step from a path square never leaves the window.
+        for ( const Maze::Point& d : Maze::cardinal_directions_ ) {
+          const Maze::Point next = { cur.row + d.row, cur.col + d.col };
+          if ( ( window[next.row][next.col] & Maze::path_bit_ ) && region[id( next )] == unlabeled ) {
+            region[id( next )] = label;
+            flood.push_back( next );
+          }
+        }
+      }
+    }
+  }
+  if ( region_sizes.empty() ) {
+    return;
+  }
+  const auto largest
+    = static_cast<uint64_t>( std::max_element( region_sizes.begin(), region_sizes.end() ) - region_sizes.begin() );
+  for ( int64_t row = 0; row < rows; row++ ) {
+    for ( int64_t col = 0; col < cols; col++ ) {
+      const uint64_t label = region[id( { row, col } )];
+      if ( label != unlabeled && label != largest ) {
+        window[row][col] = Maze::Square { 0 };
+      }
+    }
+  }
+}
+
+} // namespace
+
+uint64_t Maze_world::Chunk_key_hash::operator()( const Chunk_key& key ) const
+{
+  return chunk_seed( 0, key.row, key.col );
+}
+
+Maze_world::Maze_world( const World_args& args )
+  : seed_( args.seed )
+  , cached_chunks_( std::max( args.cached_chunks, uint64_t { 1 } ) )
+  , chunks_built_( 0 )
+  , recent_()
+  , chunks_()
+{}
+
+bool Maze_world::is_path( const Maze::Point& p )
+{
+  const Chunk& chunk
+    = chunk_at( { floor_div( p.row, chunk_squares_ ), floor_div( p.col, chunk_squares_ ) } );
+  const auto row = static_cast<uint64_t>( floor_mod( p.row, chunk_squares_ ) );
+  const auto col = static_cast<uint64_t>( floor_mod( p.col, chunk_squares_ ) );
+  const bool odd_row = row % 2;
+  const bool odd_col = col % 2;
+  if ( row == 0 ) {
+    return odd_col && col / 2 == chunk.north_door;
+  }
+  if ( col == 0 ) {
+    return odd_row && row / 2 == chunk.west_door;
+  }
+  if ( odd_row && odd_col ) {
+    return true;
+  }
+  if ( odd_row ) {
+    return chunk.passages.is_east_open( { row / 2, ( col / 2 ) - 1 } );
+  }
+  if ( odd_col ) {
+    return chunk.passages.is_south_open( { ( row / 2 ) - 1, col / 2 } );
+  }
+  return false;
+}
+
+Maze::Point Maze_world::fill_window( Maze& window, const Maze::Point& origin )
+{
+  const Maze::Point start = { floor_div( origin.row, 2 ) * 2, floor_div( origin.col, 2 ) * 2 };
+  const int64_t rows = window.row_size();
+  const int64_t cols = window.col_size();
+  for ( int64_t row = 0; row < rows; row++ ) {
+    for ( int64_t col = 0; col < cols; col++ ) {
+      const bool border = row == 0 || col == 0 || row == rows - 1 || col == cols - 1;
+      window[row][col] = border || !is_path( { start.row + row, start.col + col } ) ? Maze::Square { 0 }
+                                                                                      : Maze::path_bit_;
+    }
+  }
+  keep_largest_region( window );
+  // Glyphs only look inside the window so the forced outer ring joins up with the walls it cut.
+  const auto is_wall = [&]( int64_t row, int64_t col ) {
+    return row >= 0 && col >= 0 && row < rows && col < cols && !( window[row][col] & Maze::path_bit_ );
+  };
+  for ( int64_t row = 0; row < rows; row++ ) {
+    for ( int64_t col = 0; col < cols; col++ ) {
+      if ( !is_wall( row, col ) ) {
+        window[row][col] |= Maze::builder_bit_;
+        continue;
+      }
+      Maze::Wall_line wall = 0b0;
+      if ( is_wall( row - 1, col ) ) {
+        wall |= Maze::north_wall_;
+      }
+      if ( is_wall( row, col + 1 ) ) {
+        wall |= Maze::east_wall_;
+      }
+      if ( is_wall( row + 1, col ) ) {
+        wall |= Maze::south_wall_;
+      }
+      if ( is_wall( row, col - 1 ) ) {
+        wall |= Maze::west_wall_;
+      }
+      window[row][col] = static_cast<Maze::Square>( wall | Maze::builder_bit_ );
+    }
+  }
+  return start;
+}
+
+uint64_t Maze_world::chunks_built() const
+{
+  return chunks_built_;
+}
+
+uint64_t Maze_world::chunks_cached() const
+{
+  return recent_.size();
+}
+
+const Maze_world::Chunk& Maze_world::chunk_at( const Chunk_key& key )
+{
+  // Neighboring squares almost always share a chunk so the most recent one is checked first.
+  if ( !recent_.empty() && recent_.front().key == key ) {
+    return recent_.front();
+  }
+  const auto found = chunks_.find( key );
+  if ( found != chunks_.end() ) {
+    recent_.splice( recent_.begin(), recent_, found->second );
+    return recent_.front();
+  }
+  if ( recent_.size() == cached_chunks_ ) {
+    chunks_.erase( recent_.back().key );
+    recent_.pop_back();
+  }
+  recent_.push_front( build_chunk( key ) );
+  chunks_.insert( { key, recent_.begin() } );
+  chunks_built_++;
+  return recent_.front();
+}
+
+Maze_world::Chunk Maze_world::build_chunk( const Chunk_key& key ) const
+{
+  const uint64_t seed = chunk_seed( seed_, key.row, key.col );
+  const uint64_t odd_squares = static_cast<uint64_t>( chunk_squares_ ) + 1;
+  Passage_maze passages( Maze::Maze_args { odd_squares, odd_squares, Maze::Maze_style::sharp, {}, {} } );
+  generate_compact_recursive_backtracker_maze( passages, seed );
+  const uint64_t doors = mix( seed );
+  return { key, std::move( passages ), doors % chunk_cells_, ( doors >> 32 ) % chunk_cells_ };
+}
+
+} // namespace Builder
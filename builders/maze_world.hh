@@ -0,0 +1,87 @@
+#pragma once
+#ifndef MAZE_WORLD_HH
+#define MAZE_WORLD_HH
+#include "maze.hh"
+#include "passage_maze.hh"
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace Builder {
+
+/* A maze over unbounded coordinates. The world is cut into square chunks of chunk_squares_ on a
+ * side and a chunk is only built when a square inside it is asked for. Every chunk is a compact
+ * recursive backtracker maze seeded from a hash of the world seed and the chunk coordinate so the
+ * same seed always gives the same world no matter the order chunks are visited or evicted in.
+ *
+ * chunk (0,0)      chunk (0,1)
+ * ┌───── ──────┬────── ─────┐   Each chunk owns its north and west seam. One door is opened in
+ * │            │            │   each seam so every chunk connects to the four chunks around it.
+ * │             ←door       │
+ * │            │            │
+ *
+ * Only cached_chunks chunks are kept, least recently used first out, so memory stays constant no
+ * matter how far a walk goes. Solvers and printing work on a window Maze filled from the world.
+ */
+class Maze_world
+{
+public:
+  struct World_args
+  {
+    uint64_t seed = 0;
+    uint64_t cached_chunks = 64;
+  };
+
+  explicit Maze_world( const World_args& args );
+
+  // World coordinates may be negative. Cells sit on odd rows and columns just like a Maze.
+  bool is_path( const Maze::Point& p );
+
+  /* Fills the window with the world squares starting at origin, rounded down to even coordinates so
+   * window cells stay on odd squares. The outer ring of the window is always wall and only the
+   * largest region connected inside the window stays open, so any solver may treat the window as an
+   * ordinary maze with every start and finish reachable.
+   */
+  Maze::Point fill_window( Maze& window, const Maze::Point& origin );
+
+  uint64_t chunks_built() const;
+  uint64_t chunks_cached() const;
+
+  static constexpr uint64_t chunk_cells_ = 16;
+  static constexpr int64_t chunk_squares_ = 2 * chunk_cells_;
+
+private:
+  struct Chunk_key
+  {
+    int64_t row;
+    int64_t col;
+    bool operator==( const Chunk_key& rhs ) const = default;
+  };
+
+  struct Chunk_key_hash
+  {
+    uint64_t operator()( const Chunk_key& key ) const;
+  };
+
+  struct Chunk
+  {
+    Chunk_key key;
+    Passage_maze passages;
+    uint64_t north_door;
+    uint64_t west_door;
+  };
+
+  uint64_t seed_;
+  uint64_t cached_chunks_;
+  uint64_t chunks_built_;
+  std::list<Chunk> recent_;
+  std::unordered_map<Chunk_key, std::list<Chunk>::iterator, Chunk_key_hash> chunks_;
+
+  const Chunk& chunk_at( const Chunk_key& key );
+  Chunk build_chunk( const Chunk_key& key ) const;
+};
+
+} // namespace Builder
+
+#endif
@@ -1,48 +1,86 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
+#include <algorithm>
+#include <array>
 #include <climits>
-#include <queue>
-#include <random>
-#include <unordered_map>
+#include <cstdint>
+#include <vector>
 
 namespace Builder {
 
 namespace {
 
-struct Priority_cell
+constexpr int max_cost = 100;
+
+/* Costs are small bounded integers so the frontier is one stack of cells per cost and a cursor at
+ * the cheapest stack that may hold a cell. A push only ever moves the cursor down and a pop only
+ * walks it up past empty stacks, at most max_cost steps, so both are O(1).
+ */
+class Bucket_queue
 {
-  Maze::Point cell;
-  int priority;
-  bool operator==( const Priority_cell& rhs ) const
+public:
+  bool empty() const
   {
-    return this->priority == rhs.priority && this->cell == rhs.cell;
+    return size_ == 0;
   }
-  bool operator!=( const Priority_cell& rhs ) const { return !( *this == rhs ); }
-  bool operator<( const Priority_cell& rhs ) const { return this->priority < rhs.priority; }
-  bool operator>( const Priority_cell& rhs ) const { return this->priority > rhs.priority; }
-  bool operator<=( const Priority_cell& rhs ) const { return !( *this > rhs ); }
-  bool operator>=( const Priority_cell& rhs ) const { return !( *this < rhs ); }
-};
 
-Maze::Point pick_random_odd_point( Maze& maze )
-{
-  std::uniform_int_distribution<int> rand_row( 1, ( maze.row_size() - 2 ) / 2 );
-  std::uniform_int_distribution<int> rand_col( 1, ( maze.col_size() - 2 ) / 2 );
-  std::mt19937 generator( std::random_device {}() );
-  return { 2 * rand_row( generator ) + 1, 2 * rand_col( generator ) + 1 };
-}
+  const Maze::Point& top() const
+  {
+    return buckets_.at( cheapest_ ).back();
+  }
 
-std::unordered_map<Maze::Point, int> randomize_cell_costs( Maze& maze )
+  void push( const Maze::Point& cell, int cost )
+  {
+    buckets_.at( cost ).push_back( cell );
+    cheapest_ = std::min( cheapest_, cost );
+    size_++;
+  }
+
+  void pop()
+  {
+    buckets_.at( cheapest_ ).pop_back();
+    size_--;
+    while ( size_ && buckets_.at( cheapest_ ).empty() ) {
+      cheapest_++;
+    }
+  }
+
+private:
+  std::array<std::vector<Maze::Point>, max_cost + 1> buckets_ {};
+  int cheapest_ { max_cost };
+  uint64_t size_ { 0 };
+};
+
+// One byte per cell in row major cell order. Cells sit on odd squares so halving a point finds its cost.
+class Cell_costs
 {
-  std::unordered_map<Maze::Point, int> cell_cost = {};
-  std::uniform_int_distribution<int> random_cost( 0, 100 );
-  std::mt19937 generator( std::random_device {}() );
-  for ( int row = 1; row < maze.row_size(); row += 2 ) {
-    for ( int col = 1; col < maze.col_size(); col += 2 ) {
-      cell_cost[{ row, col }] = random_cost( generator );
+public:
+  explicit Cell_costs( const Maze& maze )
+    : cell_cols_( static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 ) )
+    , costs_( static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 ) * cell_cols_ )
+  {
+    Maze_random generator = make_maze_random();
+    for ( uint8_t& cost : costs_ ) {
+      cost = static_cast<uint8_t>( generator.below( max_cost + 1 ) );
     }
   }
-  return cell_cost;
+
+  int operator[]( const Maze::Point& cell ) const
+  {
+    return costs_[( static_cast<uint64_t>( cell.row / 2 ) * cell_cols_ ) + static_cast<uint64_t>( cell.col / 2 )];
+  }
+
+private:
+  uint64_t cell_cols_;
+  std::vector<uint8_t> costs_;
+};
+
+Maze::Point pick_random_odd_point( Maze& maze )
+{
+  Maze_random generator = make_maze_random();
+  return { ( 2 * generator.between( 1, ( maze.row_size() - 2 ) / 2 ) ) + 1,
+           ( 2 * generator.between( 1, ( maze.col_size() - 2 ) / 2 ) ) + 1 };
 }
 
 } // namespace
@@ -50,12 +88,12 @@ std::unordered_map<Maze::Point, int> randomize_cell_costs( Maze& maze )
 void generate_prim_maze( Maze& maze )
 {
   fill_maze_with_walls( maze );
-  std::unordered_map<Maze::Point, int> cell_cost = randomize_cell_costs( maze );
+  const Cell_costs cell_cost( maze );
   const Maze::Point odd_point = pick_random_odd_point( maze );
-  std::priority_queue<Priority_cell, std::vector<Priority_cell>, std::greater<>> cells;
-  cells.push( { odd_point, cell_cost[odd_point] } );
+  Bucket_queue cells;
+  cells.push( odd_point, cell_cost[odd_point] );
   while ( !cells.empty() ) {
-    const Maze::Point& cur = cells.top().cell;
+    const Maze::Point cur = cells.top();
     maze[cur.row][cur.col] |= Maze::builder_bit_;
     Maze::Point min_neighbor = {};
     int min_weight = INT_MAX;
@@ -71,7 +109,7 @@ void generate_prim_maze( Maze& maze )
     }
     if ( min_neighbor.row ) {
       join_squares( maze, cur, min_neighbor );
-      cells.push( { min_neighbor, min_weight } );
+      cells.push( min_neighbor, min_weight );
     } else {
       cells.pop();
     }
@@ -84,12 +122,12 @@ void animate_prim_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation_speed = builder_speeds_.at( static_cast<int>( speed ) );
   fill_maze_with_walls_animated( maze );
   clear_and_flush_grid( maze );
-  std::unordered_map<Maze::Point, int> cell_cost = randomize_cell_costs( maze );
+  const Cell_costs cell_cost( maze );
   const Maze::Point odd_point = pick_random_odd_point( maze );
-  std::priority_queue<Priority_cell, std::vector<Priority_cell>, std::greater<>> cells;
-  cells.push( { odd_point, cell_cost[odd_point] } );
+  Bucket_queue cells;
+  cells.push( odd_point, cell_cost[odd_point] );
   while ( !cells.empty() ) {
-    const Maze::Point& cur = cells.top().cell;
+    const Maze::Point cur = cells.top();
     maze[cur.row][cur.col] |= Maze::builder_bit_;
     Maze::Point min_neighbor = {};
     int min_weight = INT_MAX;
@@ -105,7 +143,7 @@ void animate_prim_maze( Maze& maze, Builder_speed speed )
     }
     if ( min_neighbor.row ) {
       join_squares_animated( maze, cur, min_neighbor, animation_speed );
-      cells.push( { min_neighbor, min_weight } );
+      cells.push( min_neighbor, min_weight );
     } else {
       cells.pop();
     }
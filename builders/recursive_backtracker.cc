@@ -1,32 +1,122 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 #include "maze_utilities.hh"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
-#include <random>
+#include <numeric>
 #include <thread>
+#include <vector>
 
 namespace Builder {
 
+namespace {
+
+/* The compact builder has no squares to hide backtracking marks in so it keeps the direction of
+ * every step on a stack packed at two bits per step. The stack holds O(current path length).
+ */
+class Direction_trail
+{
+public:
+  void push( uint64_t direction )
+  {
+    if ( size_ % steps_per_word_ == 0 ) {
+      steps_.push_back( 0 );
+    }
+    steps_.back() |= direction << ( ( size_ % steps_per_word_ ) * step_bits_ );
+    size_++;
+  }
+
+  uint64_t pop()
+  {
+    size_--;
+    const uint64_t direction = ( steps_.back() >> ( ( size_ % steps_per_word_ ) * step_bits_ ) ) & step_mask_;
+    if ( size_ % steps_per_word_ == 0 ) {
+      steps_.pop_back();
+    } else {
+      steps_.back() &= ~( step_mask_ << ( ( size_ % steps_per_word_ ) * step_bits_ ) );
+    }
+    return direction;
+  }
+
+  bool empty() const { return size_ == 0; }
+
+private:
+  static constexpr uint64_t step_bits_ = 2;
+  static constexpr uint64_t step_mask_ = 0b11;
+  static constexpr uint64_t steps_per_word_ = 32;
+  std::vector<uint64_t> steps_ {};
+  uint64_t size_ { 0 };
+};
+
+bool can_step( const Passage_maze& maze, const Passage_maze::Cell& cur, uint64_t direction )
+{
+  const Maze::Point& d = Maze::cardinal_directions_.at( direction );
+  if ( ( d.row < 0 && cur.row == 0 ) || ( d.col < 0 && cur.col == 0 )
+       || ( d.row > 0 && cur.row + 1 == maze.cell_rows() ) || ( d.col > 0 && cur.col + 1 == maze.cell_cols() ) ) {
+    return false;
+  }
+  // A cell with any open passage is already part of the maze.
+  return !maze.has_passage( { cur.row + d.row, cur.col + d.col } );
+}
+
+} // namespace
+
+void generate_compact_recursive_backtracker_maze( Passage_maze& maze )
+{
+  generate_compact_recursive_backtracker_maze( maze, make_maze_random()() );
+}
+
+void generate_compact_recursive_backtracker_maze( Passage_maze& maze, uint64_t seed )
+{
+  Maze_random generator( seed );
+  Passage_maze::Cell cur = { generator.below( maze.cell_rows() ), generator.below( maze.cell_cols() ) };
+  std::array<uint64_t, 4> random_directions = { 0, 1, 2, 3 };
+  Direction_trail trail;
+  for ( ;; ) {
+    generator.shuffle( random_directions );
+    bool branches_remain = false;
+    for ( const uint64_t& direction : random_directions ) {
+      if ( can_step( maze, cur, direction ) ) {
+        const Maze::Point& d = Maze::cardinal_directions_.at( direction );
+        const Passage_maze::Cell next = { cur.row + d.row, cur.col + d.col };
+        maze.join_cells( cur, next );
+        trail.push( direction );
+        cur = next;
+        branches_remain = true;
+        break;
+      }
+    }
+    if ( branches_remain ) {
+      continue;
+    }
+    if ( trail.empty() ) {
+      return;
+    }
+    // Step back the opposite way we came. Directions are north, east, south, west.
+    const Maze::Point& d = Maze::cardinal_directions_.at( trail.pop() );
+    cur = { cur.row - d.row, cur.col - d.col };
+  }
+}
+
 void generate_recursive_backtracker_maze( Maze& maze )
 {
   fill_maze_with_walls( maze );
   // Note that backtracking occurs by encoding directions into path bits. No stack needed.
-  std::mt19937 generator_( std::random_device {}() );
-  std::uniform_int_distribution<int> row_random_( 1, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_random_( 1, maze.col_size() - 2 );
+  Maze_random generator_ = make_maze_random();
 
-  const Maze::Point start
-    = { 2 * ( row_random_( generator_ ) / 2 ) + 1, 2 * ( col_random_( generator_ ) / 2 ) + 1 };
+  const Maze::Point start = { ( 2 * ( generator_.between( 1, maze.row_size() - 2 ) / 2 ) ) + 1,
+                              ( 2 * ( generator_.between( 1, maze.col_size() - 2 ) / 2 ) ) + 1 };
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
   Maze::Point cur = start;
   bool branches_remain = true;
   while ( branches_remain ) {
     // The unvisited neighbor is always random because array is re-shuffled each time.
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator_ );
+    generator_.shuffle( random_direction_indices );
     branches_remain = false;
     for ( const int& i : random_direction_indices ) {
       const Maze::Point& direction = Maze::generate_directions_.at( i );
@@ -58,17 +148,15 @@ void animate_recursive_backtracker_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
   fill_maze_with_walls_animated( maze );
   clear_and_flush_grid( maze );
-  std::mt19937 generator_( std::random_device {}() );
-  std::uniform_int_distribution<int> row_random_( 1, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_random_( 1, maze.col_size() - 2 );
-  const Maze::Point start
-    = { 2 * ( row_random_( generator_ ) / 2 ) + 1, 2 * ( col_random_( generator_ ) / 2 ) + 1 };
+  Maze_random generator_ = make_maze_random();
+  const Maze::Point start = { ( 2 * ( generator_.between( 1, maze.row_size() - 2 ) / 2 ) ) + 1,
+                              ( 2 * ( generator_.between( 1, maze.col_size() - 2 ) / 2 ) ) + 1 };
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
   Maze::Point cur = start;
   bool branches_remain = true;
   while ( branches_remain ) {
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator_ );
+    generator_.shuffle( random_direction_indices );
     branches_remain = false;
     for ( const int& i : random_direction_indices ) {
       const Maze::Point& direction = Maze::generate_directions_.at( i );
@@ -1,74 +1,208 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <random>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <stack>
 #include <thread>
+#include <vector>
 
 namespace Builder {
 
 namespace {
 
-using Height = int;
-using Width = int;
+using Height = int64_t;
+using Width = int64_t;
 
-int random_even_division( std::mt19937& generator, int axis_limit )
+int64_t random_even_division( Maze_random& generator, int64_t axis_limit )
 {
-  std::uniform_int_distribution<int> divider( 1, ( axis_limit - 2 ) / 2 );
-  return 2 * divider( generator );
+  return 2 * generator.between( 1, ( axis_limit - 2 ) / 2 );
 }
 
-int random_odd_passage( std::mt19937& generator, int axis_limit )
+int64_t random_odd_passage( Maze_random& generator, int64_t axis_limit )
 {
-  std::uniform_int_distribution<int> divider( 1, ( axis_limit - 2 ) / 2 );
-  return 2 * divider( generator ) + 1;
+  return 2 * generator.between( 1, ( axis_limit - 2 ) / 2 ) + 1;
+}
+
+/* The stream a chamber splits with in the parallel build. No two chambers share an origin and a size
+ * so the walls a seed draws do not depend on which worker takes which chamber.
+ */
+Maze_random chamber_random( uint64_t seed, const Maze_view& chamber )
+{
+  const auto origin = ( static_cast<uint64_t>( chamber.origin().row ) << 32 )
+                      | static_cast<uint64_t>( chamber.origin().col );
+  const auto size
+    = ( static_cast<uint64_t>( chamber.row_size() ) << 32 ) | static_cast<uint64_t>( chamber.col_size() );
+  return make_maze_random( seed, Xoshiro256::mix( origin ) ^ size );
+}
+
+// Chambers with fewer squares than this are finished by the thread that holds them without sharing.
+constexpr int64_t parallel_chamber_cutoff = 128 * 128;
+
+/* Splits a chamber in two with a wall that has one passage and hands both halves to push. Only the
+ * inside of the chamber is written so chambers that share a wall never write the same square. The
+ * wall glyphs are drawn once every chamber is done.
+ */
+template<typename Push>
+void split_chamber( const Maze_view& chamber, Maze_random& generator, const Push& push )
+{
+  const int64_t chamber_height = chamber.row_size();
+  const int64_t chamber_width = chamber.col_size();
+  if ( chamber_height >= chamber_width && chamber_width > 3 ) {
+    const int64_t divide = random_even_division( generator, chamber_height );
+    const int64_t passage = random_odd_passage( generator, chamber_width );
+    for ( int64_t col = 1; col < chamber_width - 1; col++ ) {
+      if ( col != passage ) {
+        chamber[divide][col] &= static_cast<Maze::Square>( ~Maze::path_bit_ );
+      }
+    }
+    push( Maze_view( chamber, { divide, 0 }, chamber_height - divide, chamber_width ) );
+    push( Maze_view( chamber, { 0, 0 }, divide + 1, chamber_width ) );
+  } else if ( chamber_width > chamber_height && chamber_height > 3 ) {
+    const int64_t divide = random_even_division( generator, chamber_width );
+    const int64_t passage = random_odd_passage( generator, chamber_height );
+    for ( int64_t row = 1; row < chamber_height - 1; row++ ) {
+      if ( row != passage ) {
+        chamber[row][divide] &= static_cast<Maze::Square>( ~Maze::path_bit_ );
+      }
+    }
+    push( Maze_view( chamber, { 0, divide }, chamber_height, chamber_width - divide ) );
+    push( Maze_view( chamber, { 0, 0 }, chamber_height, divide + 1 ) );
+  }
+}
+
+/* One deque of chambers per worker. A worker pushes and pops at the back of its own deque so it
+ * keeps dividing the chamber it just made while that chamber is still in cache. An idle worker
+ * steals from the front of another deque where the oldest and so largest chambers wait. Pending
+ * counts chambers pushed but not yet split so workers know when the whole maze is done.
+ */
+class Chamber_pool
+{
+public:
+  explicit Chamber_pool( uint64_t workers ) : queues_( workers ), pending_( 0 ) {}
+
+  void push( uint64_t worker, const Maze_view& chamber )
+  {
+    pending_.fetch_add( 1, std::memory_order_relaxed );
+    const std::scoped_lock lock( queues_[worker].lock );
+    queues_[worker].chambers.push_back( chamber );
+  }
+
+  std::optional<Maze_view> pop( uint64_t worker )
+  {
+    for ( uint64_t i = 0; i < queues_.size(); i++ ) {
+      Worker_queue& queue = queues_[( worker + i ) % queues_.size()];
+      const std::scoped_lock lock( queue.lock );
+      if ( queue.chambers.empty() ) {
+        continue;
+      }
+      if ( i == 0 ) {
+        const Maze_view chamber = queue.chambers.back();
+        queue.chambers.pop_back();
+        return chamber;
+      }
+      const Maze_view chamber = queue.chambers.front();
+      queue.chambers.pop_front();
+      return chamber;
+    }
+    return {};
+  }
+
+  void finish_one()
+  {
+    pending_.fetch_sub( 1, std::memory_order_acq_rel );
+  }
+
+  bool done() const
+  {
+    return pending_.load( std::memory_order_acquire ) == 0;
+  }
+
+private:
+  struct Worker_queue
+  {
+    std::mutex lock {};
+    std::deque<Maze_view> chambers {};
+  };
+  std::vector<Worker_queue> queues_;
+  std::atomic<uint64_t> pending_;
+};
+
+void divide_chambers( Chamber_pool& pool, uint64_t worker, uint64_t seed )
+{
+  std::stack<Maze_view> small_chambers {};
+  while ( !pool.done() ) {
+    const std::optional<Maze_view> chamber = pool.pop( worker );
+    if ( !chamber ) {
+      std::this_thread::yield();
+      continue;
+    }
+    Maze_random generator = chamber_random( seed, *chamber );
+    if ( chamber->row_size() * chamber->col_size() >= parallel_chamber_cutoff ) {
+      split_chamber( *chamber, generator, [&pool, worker]( const Maze_view& half ) { pool.push( worker, half ); } );
+      pool.finish_one();
+      continue;
+    }
+    small_chambers.push( *chamber );
+    while ( !small_chambers.empty() ) {
+      const Maze_view small = small_chambers.top();
+      small_chambers.pop();
+      split_chamber(
+        small, generator, [&small_chambers]( const Maze_view& half ) { small_chambers.push( half ); } );
+    }
+    pool.finish_one();
+  }
 }
 
 } // namespace
 
+/* Every chamber is a view that includes its own outer walls. A dividing wall splits it into two
+ * views that share the new wall so both halves still see every wall their lines must connect to.
+ * The serial build splits chambers exactly as one worker of the parallel build does and draws the
+ * wall glyphs from the path bits once every chamber is done.
+ */
 void generate_recursive_subdivision_maze( Maze& maze )
 {
   build_wall_outline( maze );
-  std::mt19937 generator( std::random_device {}() );
-  std::stack<std::tuple<Maze::Point, Height, Width>> chamber_stack(
-    { { { 0, 0 }, maze.row_size(), maze.col_size() } } );
+  Maze_random generator = make_maze_random();
+  std::stack<Maze_view> chamber_stack( { Maze_view( maze ) } );
   while ( !chamber_stack.empty() ) {
-    std::tuple<Maze::Point, Height, Width>& chamber = chamber_stack.top();
-    const Maze::Point& chamber_offset = std::get<0>( chamber );
-    const int chamber_height = std::get<1>( chamber );
-    const int chamber_width = std::get<2>( chamber );
-    if ( chamber_height >= chamber_width && chamber_width > 3 ) {
-      const int divide = random_even_division( generator, chamber_height );
-      const int passage = random_odd_passage( generator, chamber_width );
-      for ( int col = 0; col < chamber_width; col++ ) {
-        if ( col != passage ) {
-          maze[chamber_offset.row + divide][chamber_offset.col + col]
-            &= static_cast<Maze::Square>( ~Maze::path_bit_ );
-          build_wall_line( maze, { chamber_offset.row + divide, chamber_offset.col + col } );
-        }
-      }
-      // Remember to shrink height of this branch before we continue down next branch.
-      std::get<1>( chamber ) = divide + 1;
-      const Maze::Point offset = { chamber_offset.row + divide, chamber_offset.col };
-      chamber_stack.emplace( offset, chamber_height - divide, chamber_width );
-    } else if ( chamber_width > chamber_height && chamber_height > 3 ) {
-      const int divide = random_even_division( generator, chamber_width );
-      const int passage = random_odd_passage( generator, chamber_height );
-      for ( int row = 0; row < chamber_height; row++ ) {
-        if ( row != passage ) {
-          maze[chamber_offset.row + row][chamber_offset.col + divide]
-            &= static_cast<Maze::Square>( ~Maze::path_bit_ );
-          build_wall_line( maze, { chamber_offset.row + row, chamber_offset.col + divide } );
-        }
-      }
-      // In this case, we are shrinking the width.
-      std::get<2>( chamber ) = divide + 1;
-      const Maze::Point offset = { chamber_offset.row, chamber_offset.col + divide };
-      chamber_stack.emplace( offset, chamber_height, chamber_width - divide );
-    } else {
-      chamber_stack.pop();
-    }
+    const Maze_view chamber = chamber_stack.top();
+    chamber_stack.pop();
+    split_chamber(
+      chamber, generator, [&chamber_stack]( const Maze_view& half ) { chamber_stack.push( half ); } );
+  }
+  rebuild_wall_lines( maze, 0, static_cast<uint64_t>( maze.row_size() ) );
+  clear_and_flush_grid( maze );
+}
+
+/* Once a chamber is split its halves share nothing but the new wall, which neither half writes, so
+ * every chamber above the cutoff becomes a task any worker may take. The wall glyphs need to see
+ * both sides of every wall so they are drawn from the path bits in row slices at the end.
+ */
+void generate_parallel_recursive_subdivision_maze( Maze& maze )
+{
+  build_wall_outline( maze );
+  const uint64_t workers = std::max( 1U, std::thread::hardware_concurrency() );
+  const uint64_t seed = make_maze_random()();
+  Chamber_pool pool( workers );
+  pool.push( 0, Maze_view( maze ) );
+  std::vector<std::thread> threads;
+  threads.reserve( workers );
+  for ( uint64_t worker = 0; worker < workers; worker++ ) {
+    threads.emplace_back( divide_chambers, std::ref( pool ), worker, seed );
+  }
+  for ( std::thread& t : threads ) {
+    t.join();
   }
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ),
+                  [&maze]( uint64_t first, uint64_t last ) { rebuild_wall_lines( maze, first, last ); } );
   clear_and_flush_grid( maze );
 }
 
@@ -77,18 +211,18 @@ void animate_recursive_subdivision_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
   build_wall_outline( maze );
   clear_and_flush_grid( maze );
-  std::mt19937 generator( std::random_device {}() );
+  Maze_random generator = make_maze_random();
   std::stack<std::tuple<Maze::Point, Height, Width>> chamber_stack(
     { { { 0, 0 }, maze.row_size(), maze.col_size() } } );
   while ( !chamber_stack.empty() ) {
     std::tuple<Maze::Point, Height, Width>& chamber = chamber_stack.top();
     const Maze::Point& chamber_offset = std::get<0>( chamber );
-    const int chamber_height = std::get<1>( chamber );
-    const int chamber_width = std::get<2>( chamber );
+    const int64_t chamber_height = std::get<1>( chamber );
+    const int64_t chamber_width = std::get<2>( chamber );
     if ( chamber_height >= chamber_width && chamber_width > 3 ) {
-      const int divide = random_even_division( generator, chamber_height );
-      const int passage = random_odd_passage( generator, chamber_width );
-      for ( int col = 0; col < chamber_width; col++ ) {
+      const int64_t divide = random_even_division( generator, chamber_height );
+      const int64_t passage = random_odd_passage( generator, chamber_width );
+      for ( int64_t col = 0; col < chamber_width; col++ ) {
         if ( col != passage ) {
           maze[chamber_offset.row + divide][chamber_offset.col + col]
             &= static_cast<Maze::Square>( ~Maze::path_bit_ );
@@ -99,9 +233,9 @@ void animate_recursive_subdivision_maze( Maze& maze, Builder_speed speed )
       const Maze::Point offset = { chamber_offset.row + divide, chamber_offset.col };
       chamber_stack.emplace( offset, chamber_height - divide, chamber_width );
     } else if ( chamber_width > chamber_height && chamber_height > 3 ) {
-      const int divide = random_even_division( generator, chamber_width );
-      const int passage = random_odd_passage( generator, chamber_height );
-      for ( int row = 0; row < chamber_height; row++ ) {
+      const int64_t divide = random_even_division( generator, chamber_width );
+      const int64_t passage = random_odd_passage( generator, chamber_height );
+      for ( int64_t row = 0; row < chamber_height; row++ ) {
         if ( row != passage ) {
           maze[chamber_offset.row + row][chamber_offset.col + divide]
             &= static_cast<Maze::Square>( ~Maze::path_bit_ );
@@ -0,0 +1,150 @@
+#include "disjoint_set.hh"
+#include "maze_algorithms.hh"
+#include "maze_random.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Builder {
+
+namespace {
+
+// A tile smaller than this many cells on a side leaves some builders nothing to do.
+constexpr uint64_t min_tile_cells = 3;
+
+struct Tile_grid
+{
+  uint64_t rows;
+  uint64_t cols;
+};
+
+// The cells of band i out of bands split as evenly as the cell count allows.
+struct Band
+{
+  uint64_t first;
+  uint64_t last;
+};
+
+Band band_of( uint64_t cells, uint64_t bands, uint64_t i )
+{
+  return { ( i * cells ) / bands, ( ( i + 1 ) * cells ) / bands };
+}
+
+/* Tiles are as close to square as the thread count divides into, with the longer side of the tile
+ * grid along the longer side of the maze. Dimensions that cannot fit that many tiles get fewer.
+ */
+Tile_grid tile_grid( uint64_t threads, uint64_t cell_rows, uint64_t cell_cols )
+{
+  uint64_t short_side = static_cast<uint64_t>( std::sqrt( static_cast<double>( threads ) ) );
+  while ( short_side > 1 && threads % short_side ) {
+    short_side--;
+  }
+  short_side = std::max( uint64_t { 1 }, short_side );
+  const uint64_t long_side = threads / short_side;
+  Tile_grid grid
+    = cell_rows <= cell_cols ? Tile_grid { short_side, long_side } : Tile_grid { long_side, short_side };
+  grid.rows = std::clamp( grid.rows, uint64_t { 1 }, std::max( uint64_t { 1 }, cell_rows / min_tile_cells ) );
+  grid.cols = std::clamp( grid.cols, uint64_t { 1 }, std::max( uint64_t { 1 }, cell_cols / min_tile_cells ) );
+  return grid;
+}
+
+// Runs the builder on a scratch maze the size of one tile and copies its paths into place.
+void build_tile( Maze& maze, const Tile_builder& builder, Band rows, Band cols, uint64_t seed )
+{
+  const Silent_flush quiet {};
+  const Random_streams streams( seed );
+  Maze::Maze_args args {};
+  args.odd_rows = ( 2 * ( rows.last - rows.first ) ) + 1;
+  args.odd_cols = ( 2 * ( cols.last - cols.first ) ) + 1;
+  Maze tile( args );
+  builder( tile );
+  const auto row_offset = static_cast<int64_t>( 2 * rows.first );
+  const auto col_offset = static_cast<int64_t>( 2 * cols.first );
+  // The tile perimeter is the shared seam with its neighbors and stays wall so only the inside is copied.
+  for ( int64_t row = 1; row < tile.row_size() - 1; row++ ) {
+    for ( int64_t col = 1; col < tile.col_size() - 1; col++ ) {
+      if ( tile[row][col] & Maze::path_bit_ ) {
+        maze[row + row_offset][col + col_offset] = Maze::path_bit_ | Maze::builder_bit_;
+      }
+    }
+  }
+}
+
+} // namespace
+
+/* Every tile is a perfect maze of its own once its builder returns. The tiles are then the nodes of
+ * a small grid graph and a random spanning tree over that graph picks which neighboring tiles share
+ * a door. One door per tree edge joins two trees into one without a loop so the whole maze is still
+ * perfect. Builders that are not perfect, like the arena, stay as open as they were in each tile.
+ */
+void generate_tiled_maze( Maze& maze, const Tile_builder& builder, uint64_t threads )
+{
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  const Tile_grid grid = tile_grid( std::max( uint64_t { 1 }, threads ), cell_rows, cell_cols );
+
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ), [&maze]( uint64_t first, uint64_t last ) {
+    for ( uint64_t row = first; row < last; row++ ) {
+      for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+        maze[row][col] = 0;
+      }
+    }
+  } );
+  // Tile seeds are drawn here, in tile order, so the same seed builds the same tiles however threads run.
+  Maze_random gen = make_maze_random();
+  std::vector<std::thread> tiles;
+  tiles.reserve( grid.rows * grid.cols );
+  for ( uint64_t tile_row = 0; tile_row < grid.rows; tile_row++ ) {
+    for ( uint64_t tile_col = 0; tile_col < grid.cols; tile_col++ ) {
+      tiles.emplace_back( build_tile,
+                          std::ref( maze ),
+                          std::cref( builder ),
+                          band_of( cell_rows, grid.rows, tile_row ),
+                          band_of( cell_cols, grid.cols, tile_col ),
+                          gen() );
+    }
+  }
+  for ( std::thread& t : tiles ) {
+    t.join();
+  }
+
+  // Seam number tile * 2 is the door to the east neighbor and tile * 2 + 1 the door to the south.
+  std::vector<uint64_t> seams;
+  for ( uint64_t tile = 0; tile < grid.rows * grid.cols; tile++ ) {
+    if ( tile % grid.cols + 1 < grid.cols ) {
+      seams.push_back( tile * 2 );
+    }
+    if ( tile / grid.cols + 1 < grid.rows ) {
+      seams.push_back( ( tile * 2 ) + 1 );
+    }
+  }
+  gen.shuffle( seams );
+  Disjoint_set tile_sets( grid.rows * grid.cols );
+  for ( const uint64_t seam : seams ) {
+    const uint64_t tile = seam / 2;
+    const bool east = seam % 2 == 0;
+    const uint64_t neighbor = east ? tile + 1 : tile + grid.cols;
+    if ( !tile_sets.made_union( tile, neighbor ) ) {
+      continue;
+    }
+    const Band rows = band_of( cell_rows, grid.rows, tile / grid.cols );
+    const Band cols = band_of( cell_cols, grid.cols, tile % grid.cols );
+    if ( east ) {
+      const uint64_t door = rows.first + gen.below( rows.last - rows.first );
+      maze[( 2 * door ) + 1][2 * cols.last] = Maze::path_bit_ | Maze::builder_bit_;
+    } else {
+      const uint64_t door = cols.first + gen.below( cols.last - cols.first );
+      maze[2 * rows.last][( 2 * door ) + 1] = Maze::path_bit_ | Maze::builder_bit_;
+    }
+  }
+
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ),
+                  [&maze]( uint64_t first, uint64_t last ) { rebuild_wall_lines( maze, first, last ); } );
+  clear_and_flush_grid( maze );
+}
+
+} // namespace Builder
@@ -0,0 +1,212 @@
+#include "maze_algorithms.hh"
+#include "maze_random.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Builder {
+
+namespace {
+
+using Cell_id = uint64_t;
+using Arrow = uint8_t;
+using Cell_state = uint16_t;
+
+// An arrow is an index into Maze::cardinal_directions_. The root has no arrow.
+constexpr Arrow no_arrow = 4;
+// A cell is free, in the tree, or on the path of the walker whose id plus one it holds.
+constexpr Cell_state free_cell = 0;
+constexpr Cell_state tree_cell = UINT16_MAX;
+
+/* Propp and Wilson showed that if every cell but the root holds a stack of independent uniform
+ * random arrows to its neighbors, popping the top arrow of every cell on a cycle until no cycle is
+ * left always ends with the same tree no matter the order cycles are popped in, and that tree is a
+ * uniform spanning tree. Wilson's algorithm is one such order. Here every core runs Wilson walks at
+ * once over the same arrows, which is just another order, so the tree is still exactly uniform.
+ * The stacks are fixed up front: arrow k of a cell is a hash of the seed, the cell, and k, and each
+ * cell counts its own pops. The tree then depends on the seed alone, not on the cores or the order.
+ *
+ * A walker follows the current arrows and claims each cell it steps on. Only the owner of a cell
+ * ever pops its arrow, so a loop on a walker's own path is a real cycle of the arrows and may be
+ * popped. A path that reaches the tree joins it. A walker that steps on a cell another walker owns
+ * waits if its id is lower and otherwise lets go of its whole path without popping anything and
+ * starts over. Waits only ever point to higher ids so two walkers never wait on each other.
+ */
+class Cycle_popper
+{
+public:
+  Cycle_popper( uint64_t cell_rows, uint64_t cell_cols )
+    : rows_( cell_rows )
+    , cols_( cell_cols )
+    , seed_( 0 )
+    , arrows_( cell_rows * cell_cols, no_arrow )
+    , pops_( cell_rows * cell_cols, 0 )
+    , states_( cell_rows * cell_cols )
+  {}
+
+  void pop_all_cycles()
+  {
+    const uint64_t cells = arrows_.size();
+    Maze_random gen = make_maze_random();
+    seed_ = gen();
+    for_each_slice( cells, [this]( uint64_t first, uint64_t last ) {
+      for ( Cell_id cell = first; cell < last; cell++ ) {
+        arrows_[cell] = random_arrow( cell, 0 );
+        states_[cell].store( free_cell, std::memory_order_relaxed );
+      }
+    } );
+    const Cell_id root = gen.below( cells );
+    arrows_[root] = no_arrow;
+    states_[root].store( tree_cell, std::memory_order_relaxed );
+
+    const uint64_t workers
+      = std::min( uint64_t { tree_cell - 1 }, uint64_t { std::max( 1U, std::thread::hardware_concurrency() ) } );
+    const uint64_t slice = ( cells + workers - 1 ) / workers;
+    std::vector<std::thread> threads;
+    threads.reserve( workers );
+    for ( uint64_t worker = 0; worker < workers && worker * slice < cells; worker++ ) {
+      threads.emplace_back( [this, worker, slice, cells]() {
+        const Cell_id last = std::min( cells, ( worker + 1 ) * slice );
+        walk_from_each( static_cast<Cell_state>( worker + 1 ), worker * slice, last );
+      } );
+    }
+    for ( std::thread& t : threads ) {
+      t.join();
+    }
+  }
+
+  Arrow arrow( Cell_id cell ) const
+  {
+    return arrows_[cell];
+  }
+
+private:
+  uint64_t rows_;
+  uint64_t cols_;
+  uint64_t seed_;
+  std::vector<Arrow> arrows_;
+  // Only the walker that owns a cell pops it so the count travels with the cell state like the arrow.
+  std::vector<uint32_t> pops_;
+  std::vector<std::atomic<Cell_state>> states_;
+
+  // Arrow pop of the cell, a uniform arrow to one of its neighbors inside the maze.
+  Arrow random_arrow( Cell_id cell, uint32_t pop ) const
+  {
+    const uint64_t row = cell / cols_;
+    const uint64_t col = cell % cols_;
+    for ( uint64_t word = Xoshiro256::mix( Xoshiro256::mix( seed_ ^ cell ) + pop );;
+          word = Xoshiro256::mix( word ) ) {
+      for ( uint64_t bits = word, draws = 0; draws < 32; bits >>= 2, draws++ ) {
+        const auto arrow = static_cast<Arrow>( bits & 0b11 );
+        if ( ( arrow == 0 && row > 0 ) || ( arrow == 1 && col + 1 < cols_ ) || ( arrow == 2 && row + 1 < rows_ )
+             || ( arrow == 3 && col > 0 ) ) {
+          return arrow;
+        }
+      }
+    }
+  }
+
+  Cell_id target( Cell_id cell ) const
+  {
+    switch ( arrows_[cell] ) {
+      case 0:
+        return cell - cols_;
+      case 1:
+        return cell + 1;
+      case 2:
+        return cell + cols_;
+      default:
+        return cell - 1;
+    }
+  }
+
+  void release( std::vector<Cell_id>& path, uint64_t from, Cell_state state )
+  {
+    for ( uint64_t i = from; i < path.size(); i++ ) {
+      states_[path[i]].store( state, std::memory_order_release );
+    }
+    path.resize( from );
+  }
+
+  void walk_from_each( Cell_state me, Cell_id first, Cell_id last )
+  {
+    std::vector<Cell_id> path {};
+    for ( Cell_id start = first; start < last; ) {
+      Cell_state state = states_[start].load( std::memory_order_acquire );
+      if ( state == tree_cell ) {
+        start++;
+        continue;
+      }
+      if ( state != free_cell
+           || !states_[start].compare_exchange_strong( state, me, std::memory_order_acq_rel ) ) {
+        std::this_thread::yield();
+        continue;
+      }
+      path.push_back( start );
+      while ( !path.empty() ) {
+        const Cell_id next = target( path.back() );
+        state = states_[next].load( std::memory_order_acquire );
+        if ( state == tree_cell ) {
+          release( path, 0, tree_cell );
+        } else if ( state == me ) {
+          // Every cell after next on the path loops back to it. Pop them all and walk on from next.
+          const auto loop = static_cast<uint64_t>( std::find( path.rbegin(), path.rend(), next ) - path.rbegin() );
+          const uint64_t loop_start = path.size() - loop - 1;
+          for ( uint64_t i = loop_start; i < path.size(); i++ ) {
+            arrows_[path[i]] = random_arrow( path[i], ++pops_[path[i]] );
+          }
+          release( path, loop_start + 1, free_cell );
+        } else if ( state == free_cell ) {
+          if ( states_[next].compare_exchange_strong( state, me, std::memory_order_acq_rel ) ) {
+            path.push_back( next );
+          }
+        } else if ( me < state ) {
+          std::this_thread::yield();
+        } else {
+          release( path, 0, free_cell );
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+};
+
+} // namespace
+
+void generate_cycle_popping_wilson_maze( Maze& maze )
+{
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  Cycle_popper tree( cell_rows, cell_cols );
+  tree.pop_all_cycles();
+
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ), [&maze]( uint64_t first, uint64_t last ) {
+    for ( uint64_t row = first; row < last; row++ ) {
+      for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+        maze[row][col] = row % 2 && col % 2 ? Maze::path_bit_ | Maze::builder_bit_ : Maze::Square { 0 };
+      }
+    }
+  } );
+  // Each cell opens the wall its arrow crosses. Two cells never cross the same wall in a tree.
+  for_each_slice( cell_rows, [&maze, &tree, cell_cols]( uint64_t first, uint64_t last ) {
+    for ( uint64_t row = first; row < last; row++ ) {
+      for ( uint64_t col = 0; col < cell_cols; col++ ) {
+        const Arrow arrow = tree.arrow( ( row * cell_cols ) + col );
+        if ( arrow == no_arrow ) {
+          continue;
+        }
+        const Maze::Point& step = Maze::cardinal_directions_.at( arrow );
+        maze[static_cast<int64_t>( ( 2 * row ) + 1 ) + step.row][static_cast<int64_t>( ( 2 * col ) + 1 ) + step.col]
+          = Maze::path_bit_ | Maze::builder_bit_;
+      }
+    }
+  } );
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ),
+                  [&maze]( uint64_t first, uint64_t last ) { rebuild_wall_lines( maze, first, last ); } );
+  clear_and_flush_grid( maze );
+}
+
+} // namespace Builder
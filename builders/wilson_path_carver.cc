@@ -1,9 +1,10 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <random>
+#include <numeric>
 #include <thread>
 
 namespace Builder {
@@ -146,12 +147,12 @@ void animate_erase_loop( Maze& maze, const Loop& loop, Speed_unit speed )
   }
 }
 
-bool continue_random_walks( Maze& maze, Random_walk& cur )
+bool continue_random_walks( Maze& maze, Random_walk& cur, Unvisited_scan& unvisited )
 {
   if ( has_builder_bit( maze, cur.next ) ) {
     build_with_marks( maze, cur.walk, cur.next );
     connect_walk_to_maze( maze, cur.walk );
-    cur.walk = choose_arbitrary_point( maze, Parity_point::odd );
+    cur.walk = unvisited.next( maze );
 
     if ( !cur.walk.row ) {
       return false;
@@ -178,12 +179,12 @@ bool continue_random_walks( Maze& maze, Random_walk& cur )
   return true;
 }
 
-bool animate_random_walks( Maze& maze, Random_walk& cur, Speed_unit speed )
+bool animate_random_walks( Maze& maze, Random_walk& cur, Unvisited_scan& unvisited, Speed_unit speed )
 {
   if ( has_builder_bit( maze, cur.next ) ) {
     animate_with_marks( maze, cur.walk, cur.next, speed );
     animate_walk_to_maze( maze, cur.walk, speed );
-    cur.walk = choose_arbitrary_point( maze, Parity_point::odd );
+    cur.walk = unvisited.next( maze );
 
     if ( !cur.walk.row ) {
       return false;
@@ -221,21 +222,21 @@ void generate_wilson_path_carver_maze( Maze& maze )
    * Wilson's algorithm to work two points must both be even or odd to find each other. For any
    * number N, 2 * N + 1 is always odd, 2 * N is always even.
    */
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution<int> row_rand( 2, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_rand( 2, maze.col_size() - 2 );
-  const Maze::Point start = { 2 * ( row_rand( generator ) / 2 ) + 1, 2 * ( col_rand( generator ) / 2 ) + 1 };
+  Maze_random generator = make_maze_random();
+  const Maze::Point start = { ( 2 * ( generator.between( 2, maze.row_size() - 2 ) / 2 ) ) + 1,
+                              ( 2 * ( generator.between( 2, maze.col_size() - 2 ) / 2 ) ) + 1 };
 
   build_path( maze, start );
   maze[start.row][start.col] |= Maze::builder_bit_;
   Random_walk cur = { {}, { 1, 1 }, {} };
   maze[cur.walk.row][cur.walk.col] &= static_cast<Maze::Backtrack_marker>( ~Maze::markers_mask_ );
+  Unvisited_scan unvisited( Parity_point::odd );
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
 
   for ( ;; ) {
     maze[cur.walk.row][cur.walk.col] |= Maze::start_bit_;
-    std::shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
 
     for ( const int& i : random_direction_indices ) {
 
@@ -244,7 +245,7 @@ void generate_wilson_path_carver_maze( Maze& maze )
       if ( !is_valid_random_step( maze, cur.next, cur.prev ) ) {
         continue;
       }
-      if ( !continue_random_walks( maze, cur ) ) {
+      if ( !continue_random_walks( maze, cur, unvisited ) ) {
         clear_and_flush_grid( maze );
         return;
       }
@@ -258,22 +259,22 @@ void animate_wilson_path_carver_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
   fill_maze_with_walls_animated( maze );
   clear_and_flush_grid( maze );
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution<int> row_rand( 2, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_rand( 2, maze.col_size() - 2 );
-  const Maze::Point start = { 2 * ( row_rand( generator ) / 2 ) + 1, 2 * ( col_rand( generator ) / 2 ) + 1 };
+  Maze_random generator = make_maze_random();
+  const Maze::Point start = { ( 2 * ( generator.between( 2, maze.row_size() - 2 ) / 2 ) ) + 1,
+                              ( 2 * ( generator.between( 2, maze.col_size() - 2 ) / 2 ) ) + 1 };
 
   build_path( maze, start );
   flush_cursor_maze_coordinate( maze, start );
   maze[start.row][start.col] |= Maze::builder_bit_;
   Random_walk cur = { {}, { 1, 1 }, {} };
   maze[cur.walk.row][cur.walk.col] &= static_cast<Maze::Backtrack_marker>( ~Maze::markers_mask_ );
+  Unvisited_scan unvisited( Parity_point::odd );
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
 
   for ( ;; ) {
     maze[cur.walk.row][cur.walk.col] |= Maze::start_bit_;
-    std::shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
 
     for ( const int& i : random_direction_indices ) {
 
@@ -282,7 +283,7 @@ void animate_wilson_path_carver_maze( Maze& maze, Builder_speed speed )
       if ( !is_valid_random_step( maze, cur.next, cur.prev ) ) {
         continue;
       }
-      if ( !animate_random_walks( maze, cur, animation ) ) {
+      if ( !animate_random_walks( maze, cur, unvisited, animation ) ) {
         return;
       }
       break;
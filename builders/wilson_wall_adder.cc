@@ -1,9 +1,10 @@
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <random>
+#include <numeric>
 #include <thread>
 
 namespace Builder {
@@ -144,12 +145,12 @@ void animate_erase_loop( Maze& maze, const Loop& loop, Speed_unit speed )
   }
 }
 
-bool continue_random_walks( Maze& maze, Random_walk& cur )
+bool continue_random_walks( Maze& maze, Random_walk& cur, Unvisited_scan& unvisited )
 {
   if ( has_builder_bit( maze, cur.next ) ) {
     join_walk_walls( maze, cur.walk, cur.next );
     connect_walk_to_maze( maze, cur.walk );
-    cur.walk = choose_arbitrary_point( maze, Parity_point::even );
+    cur.walk = unvisited.next( maze );
 
     if ( !cur.walk.row ) {
       return false;
@@ -178,12 +179,12 @@ bool continue_random_walks( Maze& maze, Random_walk& cur )
   return true;
 };
 
-bool animate_random_walks( Maze& maze, Random_walk& cur, Speed_unit speed )
+bool animate_random_walks( Maze& maze, Random_walk& cur, Unvisited_scan& unvisited, Speed_unit speed )
 {
   if ( has_builder_bit( maze, cur.next ) ) {
     animate_walk_walls( maze, cur.walk, cur.next, speed );
     animate_walk_to_maze( maze, cur.walk, speed );
-    cur.walk = choose_arbitrary_point( maze, Parity_point::even );
+    cur.walk = unvisited.next( maze );
 
     if ( !cur.walk.row ) {
       return false;
@@ -218,23 +219,25 @@ void generate_wilson_wall_adder_maze( Maze& maze )
 {
   build_wall_outline( maze );
   // Walls must start and connect between even squares.
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution<int> row_rand( 2, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_rand( 2, maze.col_size() - 2 );
-  Random_walk cur = { {}, { 2 * ( row_rand( generator ) / 2 ), 2 * ( col_rand( generator ) / 2 ) }, {} };
+  Maze_random generator = make_maze_random();
+  Random_walk cur = { {},
+                      { 2 * ( generator.between( 2, maze.row_size() - 2 ) / 2 ),
+                        2 * ( generator.between( 2, maze.col_size() - 2 ) / 2 ) },
+                      {} };
+  Unvisited_scan unvisited( Parity_point::even );
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
   for ( ;; ) {
     // Every walk is distinguished from the maze with the start bit.
     maze[cur.walk.row][cur.walk.col] |= Maze::start_bit_;
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     for ( const int& i : random_direction_indices ) {
       const Maze::Point& p = Maze::generate_directions_.at( i );
       cur.next = { cur.walk.row + p.row, cur.walk.col + p.col };
       if ( !is_valid_walk_step( maze, cur.next, cur.prev ) ) {
         continue;
       }
-      if ( !continue_random_walks( maze, cur ) ) {
+      if ( !continue_random_walks( maze, cur, unvisited ) ) {
         clear_and_flush_grid( maze );
         return;
       }
@@ -248,24 +251,26 @@ void animate_wilson_wall_adder_maze( Maze& maze, Builder_speed speed )
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
   build_wall_outline( maze );
   clear_and_flush_grid( maze );
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution<int> row_rand( 2, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_rand( 2, maze.col_size() - 2 );
-  Random_walk cur = { {}, { 2 * ( row_rand( generator ) / 2 ), 2 * ( col_rand( generator ) / 2 ) }, {} };
+  Maze_random generator = make_maze_random();
+  Random_walk cur = { {},
+                      { 2 * ( generator.between( 2, maze.row_size() - 2 ) / 2 ),
+                        2 * ( generator.between( 2, maze.col_size() - 2 ) / 2 ) },
+                      {} };
 
+  Unvisited_scan unvisited( Parity_point::even );
   std::vector<int> random_direction_indices( Maze::generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
   for ( ;; ) {
     // Every walk is distinguished from the maze with the start bit.
     maze[cur.walk.row][cur.walk.col] |= Maze::start_bit_;
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     for ( const int& i : random_direction_indices ) {
       const Maze::Point& p = Maze::generate_directions_.at( i );
       cur.next = { cur.walk.row + p.row, cur.walk.col + p.col };
       if ( !is_valid_walk_step( maze, cur.next, cur.prev ) ) {
         continue;
       }
-      if ( !animate_random_walks( maze, cur, animation ) ) {
+      if ( !animate_random_walks( maze, cur, unvisited, animation ) ) {
         return;
       }
       break;
@@ -15,3 +15,9 @@ endif()
 if ("${CMAKE_CXX_COMPILER_ID}" STREQUAL "Clang" OR "${CMAKE_CXX_COMPILER_ID}" STREQUAL "GNU")
     set (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wpedantic -Wextra -Weffc++ -Werror -Wshadow -Wpointer-arith -Wcast-qual -Wformat=2 -Wno-unqualified-std-cast-call")
 endif()
+
+# Maze row access is unchecked by default. Debug builds may opt into bounds checks on every access.
+option (MAZE_CHECKED_ACCESS "Bounds check every Builder::Maze row access." OFF)
+if (MAZE_CHECKED_ACCESS)
+    add_compile_definitions (MAZE_CHECKED_ACCESS)
+endif ()
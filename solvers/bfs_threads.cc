@@ -1,11 +1,17 @@
+#include "bit_plane_maze.hh"
+#include "maze_random.hh"
 #include "maze_solvers.hh"
 #include "my_queue.hh"
 #include "print_utilities.hh"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
-#include <random>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -37,57 +43,120 @@ struct Solver_monitor
   }
 };
 
-void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
+using Plane_word = Bit_plane_maze::Plane_word;
+
+// The squares of one plane word that are all on the same level of the search.
+struct Frontier_word
 {
-  // This will be how we rebuild the path because queue does not represent the current path.
-  std::unordered_map<Builder::Maze::Point, Builder::Maze::Point>& seen = monitor.thread_maps[id.index];
-  seen[monitor.starts.at( id.index )] = { -1, -1 };
-  My_queue<Builder::Maze::Point>& bfs = monitor.thread_queues[id.index];
-  bfs.push( monitor.starts.at( id.index ) );
-  Builder::Maze::Point cur = monitor.starts.at( id.index );
-  while ( !bfs.empty() ) {
+  uint64_t word;
+  Plane_word squares;
+};
+
+/* Breadth first search over the bit-planes a whole word at a time. The next level is every unseen
+ * path bit beside the current one, found with shifts into the same word, its two neighbors in the
+ * row, and the words above and below, so one step covers every frontier square a word holds. A
+ * square keeps only its level mod three in two planes. Neighbors are never more than one level
+ * apart so the way back to the start is always the one seen neighbor a level behind.
+ */
+void complete_hunt( Bit_plane_maze& maze, Solver_monitor& monitor, Thread_id id )
+{
+  const uint64_t words_per_row = maze.words_per_row();
+  const uint64_t words = words_per_row * static_cast<uint64_t>( maze.row_size() );
+  std::array<std::vector<Plane_word>, 2> level_mod_three { std::vector<Plane_word>( words, 0 ),
+                                                           std::vector<Plane_word>( words, 0 ) };
+  std::vector<Plane_word> next_level( words, 0 );
+  std::vector<uint64_t> next_words {};
+  const Builder::Maze::Point start = monitor.starts.at( id.index );
+  std::vector<Frontier_word> frontier { { maze.word_index( start ), Bit_plane_maze::bit( start ) } };
+  maze.mark_seen_word( id.index, frontier.front().word, frontier.front().squares );
+  const auto reach = [&]( uint64_t word, Plane_word squares ) {
+    squares &= maze.path_word( word ) & ~maze.seen_word( id.index, word );
+    if ( !squares ) {
+      return;
+    }
+    if ( !next_level[word] ) {
+      next_words.push_back( word );
+    }
+    next_level[word] |= squares;
+  };
+  uint64_t level = 0;
+  std::optional<Builder::Maze::Point> finish {};
+  while ( !frontier.empty() && !finish ) {
     // Lock? Garbage read stolen mid write by winning thread is still ok for program logic.
     if ( monitor.winning_index ) {
-      break;
+      return;
     }
-
-    cur = bfs.front();
-    bfs.pop();
-
-    monitor.monitor.lock();
-    if ( maze[cur.row][cur.col] & finish_bit_ ) {
-      if ( !monitor.winning_index ) {
-        monitor.winning_index = id.index;
+    for ( const Frontier_word& f : frontier ) {
+      const Plane_word found = f.squares & maze.finish_word( f.word );
+      if ( found ) {
+        finish = maze.point( f.word, static_cast<uint64_t>( std::countr_zero( found ) ) );
+        break;
       }
-      monitor.monitor.unlock();
+      // This creates a nice fanning out of mixed color for each searching thread.
+      maze.paint_word( id.index, f.word, f.squares );
+    }
+    if ( finish ) {
       break;
     }
-    // This creates a nice fanning out of mixed color for each searching thread.
-    maze[cur.row][cur.col] |= id.paint;
-    monitor.monitor.unlock();
-
-    // Bias each thread towards the direction it was dispatched when we first sent it.
+    for ( const Frontier_word& f : frontier ) {
+      const uint64_t word_in_row = f.word % words_per_row;
+      reach( f.word, ( f.squares << 1 ) | ( f.squares >> 1 ) );
+      if ( word_in_row > 0 ) {
+        reach( f.word - 1, f.squares << ( Bit_plane_maze::squares_per_word_ - 1 ) );
+      }
+      if ( word_in_row + 1 < words_per_row ) {
+        reach( f.word + 1, f.squares >> ( Bit_plane_maze::squares_per_word_ - 1 ) );
+      }
+      if ( f.word >= words_per_row ) {
+        reach( f.word - words_per_row, f.squares );
+      }
+      if ( f.word + words_per_row < words ) {
+        reach( f.word + words_per_row, f.squares );
+      }
+    }
+    level++;
+    frontier.clear();
+    for ( const uint64_t word : next_words ) {
+      const Plane_word squares = next_level[word];
+      next_level[word] = 0;
+      maze.mark_seen_word( id.index, word, squares );
+      if ( level % 3 ) {
+        level_mod_three.at( ( level % 3 ) - 1 )[word] |= squares;
+      }
+      frontier.push_back( { word, squares } );
+    }
+    next_words.clear();
+  }
+  if ( !finish ) {
+    return;
+  }
+  monitor.monitor.lock();
+  const bool won = !monitor.winning_index;
+  if ( won ) {
+    monitor.winning_index = id.index;
+  }
+  monitor.monitor.unlock();
+  if ( !won ) {
+    return;
+  }
+  const auto level_of = [&]( const Builder::Maze::Point& p ) {
+    const uint64_t word = maze.word_index( p );
+    const Plane_word square = Bit_plane_maze::bit( p );
+    return ( level_mod_three[0][word] & square ? 1U : 0U ) | ( level_mod_three[1][word] & square ? 2U : 0U );
+  };
+  Builder::Maze::Point cur = finish.value();
+  for ( uint64_t step = level; step > 0; step-- ) {
     int direction_index = id.index;
     do {
       const Builder::Maze::Point& p = cardinal_directions_.at( direction_index );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
-      const bool seen_next = seen.contains( next );
-
-      monitor.monitor.lock();
-      const bool push_next = !seen_next && ( maze[next.row][next.col] & Builder::Maze::path_bit_ );
-      monitor.monitor.unlock();
-
-      if ( push_next ) {
-        seen[next] = cur;
-        bfs.push( next );
+      if ( maze.is_seen( id.index, next ) && level_of( next ) == ( step - 1 ) % 3 ) {
+        cur = next;
+        break;
       }
       ++direction_index %= cardinal_directions_.size();
     } while ( direction_index != id.index );
-  }
-  cur = seen.at( cur );
-  while ( cur.row > 0 ) {
     monitor.thread_paths[id.index].push_back( cur );
-    cur = seen.at( cur );
   }
 }
 
@@ -250,14 +319,16 @@ void solve_with_bfs_thread_hunt( Builder::Maze& maze )
   maze[monitor.starts.at( 0 ).row][monitor.starts.at( 0 ).col] |= start_bit_;
   const Builder::Maze::Point finish = pick_random_point( maze );
   maze[finish.row][finish.col] |= finish_bit_;
+  Bit_plane_maze planes( maze );
   std::vector<std::thread> threads( num_threads_ );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread { i_thread, thread_masks_.at( i_thread ) };
-    threads[i_thread] = std::thread( complete_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
+    threads[i_thread] = std::thread( complete_hunt, std::ref( planes ), std::ref( monitor ), this_thread );
   }
   for ( std::thread& t : threads ) {
     t.join();
   }
+  planes.store( maze );
 
   if ( monitor.winning_index ) {
     // It is cool to see the shortest path that the winning thread took to victory
@@ -400,16 +471,18 @@ void solve_with_bfs_thread_corners( Builder::Maze& maze )
   maze[finish.row][finish.col] |= Builder::Maze::path_bit_;
   maze[finish.row][finish.col] |= finish_bit_;
 
+  Bit_plane_maze planes( maze );
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
-    threads[i_thread] = std::thread( complete_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
+    threads[i_thread] = std::thread( complete_hunt, std::ref( planes ), std::ref( monitor ), this_thread );
   }
   for ( std::thread& t : threads ) {
     t.join();
   }
+  planes.store( maze );
   print_maze( maze );
   print_overlap_key();
   print_hunt_solution_message( monitor.winning_index );
@@ -442,7 +515,7 @@ void animate_with_bfs_thread_corners( Builder::Maze& maze, Solver_speed speed )
 
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
     threads[i_thread] = std::thread( animate_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
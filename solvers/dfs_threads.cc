@@ -1,3 +1,5 @@
+#include "bit_plane_maze.hh"
+#include "maze_random.hh"
 #include "maze_solvers.hh"
 #include "print_utilities.hh"
 
@@ -6,7 +8,6 @@
 #include <iostream>
 #include <mutex>
 #include <optional>
-#include <random>
 #include <thread>
 #include <vector>
 
@@ -31,13 +32,11 @@ struct Solver_monitor
   }
 };
 
-void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
+void complete_hunt( Bit_plane_maze& maze, Solver_monitor& monitor, Thread_id id )
 {
-  /* We have useful bits in a square. Each square can use a unique bit to track seen threads.
-   * Each thread could maintain its own hashset, but this is much more space efficient. Use
-   * the space the maze already occupies and provides.
+  /* Each thread tracks the squares it has seen in its own bit-plane. Only this thread writes it so
+   * there is no lock when we mark or test a square. The path and finish planes are read only.
    */
-  const Thread_cache seen = id.paint << thread_tag_offset_;
   // Each thread only needs enough space for an O(current path length) stack.
   std::vector<Builder::Maze::Point>& dfs = monitor.thread_paths[id.index];
   dfs.push_back( monitor.starts.at( id.index ) );
@@ -51,8 +50,8 @@ void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
     // Don't pop() yet!
     cur = dfs.back();
 
-    monitor.monitor.lock();
-    if ( maze[cur.row][cur.col] & finish_bit_ ) {
+    if ( maze.is_finish( cur ) ) {
+      monitor.monitor.lock();
       if ( !monitor.winning_index ) {
         monitor.winning_index = id.index;
       }
@@ -60,8 +59,7 @@ void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
       dfs.pop_back();
       break;
     }
-    maze[cur.row][cur.col] |= seen;
-    monitor.monitor.unlock();
+    maze.mark_seen( id.index, cur );
 
     // Bias each thread's first choice towards orginal dispatch direction. More coverage.
     int direction_index = id.index;
@@ -69,13 +67,7 @@ void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
     do {
       const Builder::Maze::Point& p = cardinal_directions_.at( direction_index );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
-
-      monitor.monitor.lock();
-      const bool push_next
-        = !( maze[next.row][next.col] & seen ) && ( maze[next.row][next.col] & Builder::Maze::path_bit_ );
-      monitor.monitor.unlock();
-
-      if ( push_next ) {
+      if ( !maze.is_seen( id.index, next ) && maze.is_path( next ) ) {
         found_branch_to_explore = true;
         dfs.push_back( next );
         break;
@@ -86,12 +78,10 @@ void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
       dfs.pop_back();
     }
   }
-  monitor.monitor.lock();
   // Another benefit of true depth first search is our stack holds path to exact location.
   for ( const Builder::Maze::Point& p : dfs ) {
-    maze[p.row][p.col] |= id.paint;
+    maze.paint( id.index, p );
   }
-  monitor.monitor.unlock();
 }
 
 void animate_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
@@ -153,28 +143,29 @@ void animate_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
   }
 }
 
-void complete_gather( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
+void complete_gather( Bit_plane_maze& maze, Solver_monitor& monitor, Thread_id id )
 {
-  const Thread_cache seen = id.paint << thread_tag_offset_;
   std::vector<Builder::Maze::Point>& dfs = monitor.thread_paths[id.index];
   dfs.push_back( monitor.starts.at( id.index ) );
   Builder::Maze::Point cur = monitor.starts.at( id.index );
   while ( !dfs.empty() ) {
     cur = dfs.back();
 
-    monitor.monitor.lock();
-    // We are the first thread to this finish! Claim it!
-    if ( maze[cur.row][cur.col] & finish_bit_ && !( maze[cur.row][cur.col] & cache_mask_ ) ) {
-      maze[cur.row][cur.col] |= seen;
-      dfs.pop_back();
-      for ( const Builder::Maze::Point& p : dfs ) {
-        maze[p.row][p.col] |= id.paint;
+    if ( maze.is_finish( cur ) ) {
+      monitor.monitor.lock();
+      // We are the first thread to this finish! Claim it!
+      if ( !maze.is_seen_by_any( cur ) ) {
+        maze.mark_seen( id.index, cur );
+        monitor.monitor.unlock();
+        dfs.pop_back();
+        for ( const Builder::Maze::Point& p : dfs ) {
+          maze.paint( id.index, p );
+        }
+        return;
       }
       monitor.monitor.unlock();
-      return;
     }
-    maze[cur.row][cur.col] |= seen;
-    monitor.monitor.unlock();
+    maze.mark_seen( id.index, cur );
 
     // Bias each thread's first choice towards orginal dispatch direction. More coverage.
     int direction_index = id.index;
@@ -182,11 +173,7 @@ void complete_gather( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id
     do {
       const Builder::Maze::Point& p = cardinal_directions_.at( direction_index );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
-      monitor.monitor.lock();
-      const bool push_next
-        = !( maze[next.row][next.col] & seen ) && ( maze[next.row][next.col] & Builder::Maze::path_bit_ );
-      monitor.monitor.unlock();
-      if ( push_next ) {
+      if ( !maze.is_seen( id.index, next ) && maze.is_path( next ) ) {
         found_branch_to_explore = true;
         dfs.push_back( next );
         break;
@@ -260,15 +247,17 @@ void solve_with_dfs_thread_hunt( Builder::Maze& maze )
   maze[monitor.starts.at( 0 ).row][monitor.starts.at( 0 ).col] |= start_bit_;
   const Builder::Maze::Point finish = pick_random_point( maze );
   maze[finish.row][finish.col] |= finish_bit_;
+  Bit_plane_maze planes( maze );
   std::vector<std::thread> threads( num_threads_ );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread { i_thread, thread_masks_.at( i_thread ) };
-    threads[i_thread] = std::thread( complete_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
+    threads[i_thread] = std::thread( complete_hunt, std::ref( planes ), std::ref( monitor ), this_thread );
   }
 
   for ( std::thread& t : threads ) {
     t.join();
   }
+  planes.store( maze );
   print_maze( maze );
   print_overlap_key();
   print_hunt_solution_message( monitor.winning_index );
@@ -284,15 +273,17 @@ void solve_with_dfs_thread_gather( Builder::Maze& maze )
     const Builder::Maze::Point finish = pick_random_point( maze );
     maze[finish.row][finish.col] |= finish_bit_;
   }
+  Bit_plane_maze planes( maze );
   std::vector<std::thread> threads( num_threads_ );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread { i_thread, thread_masks_.at( i_thread ) };
-    threads[i_thread] = std::thread( complete_gather, std::ref( maze ), std::ref( monitor ), this_thread );
+    threads[i_thread] = std::thread( complete_gather, std::ref( planes ), std::ref( monitor ), this_thread );
   }
 
   for ( std::thread& t : threads ) {
     t.join();
   }
+  planes.store( maze );
   print_maze( maze );
   print_overlap_key();
   print_gather_solution_message();
@@ -314,16 +305,18 @@ void solve_with_dfs_thread_corners( Builder::Maze& maze )
   maze[finish.row][finish.col] |= Builder::Maze::path_bit_;
   maze[finish.row][finish.col] |= finish_bit_;
 
+  Bit_plane_maze planes( maze );
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
-    threads[i_thread] = std::thread( complete_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
+    threads[i_thread] = std::thread( complete_hunt, std::ref( planes ), std::ref( monitor ), this_thread );
   }
   for ( std::thread& t : threads ) {
     t.join();
   }
+  planes.store( maze );
   print_maze( maze );
   print_overlap_key();
   print_hunt_solution_message( monitor.winning_index );
@@ -412,7 +405,7 @@ void animate_with_dfs_thread_corners( Builder::Maze& maze, Solver_speed speed )
 
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
     threads[i_thread] = std::thread( animate_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
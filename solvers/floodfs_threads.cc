@@ -1,3 +1,4 @@
+#include "maze_random.hh"
 #include "maze_solvers.hh"
 #include "print_utilities.hh"
 
@@ -6,7 +7,6 @@
 #include <iostream>
 #include <mutex>
 #include <optional>
-#include <random>
 #include <thread>
 #include <vector>
 
@@ -317,7 +317,7 @@ void solve_with_floodfs_thread_corners( Builder::Maze& maze )
 
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
     threads[i_thread] = std::thread( complete_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
@@ -438,7 +438,7 @@ void animate_with_floodfs_thread_corners( Builder::Maze& maze, Solver_speed spee
 
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
     threads[i_thread] = std::thread( animate_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
@@ -1,10 +1,11 @@
+#include "maze_random.hh"
 #include "maze_solvers.hh"
 #include "print_utilities.hh"
 
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <random>
+#include <numeric>
 #include <thread>
 #include <vector>
 
@@ -40,7 +41,7 @@ void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
   Builder::Maze::Point cur = monitor.starts.at( id.index );
   std::vector<int> random_direction_indices( generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
-  std::mt19937 generator( std::random_device {}() );
+  Maze_random generator = make_maze_random();
   while ( !dfs.empty() ) {
     // Lock? Garbage read stolen mid write by winning thread is still ok for program logic.
     if ( monitor.winning_index ) {
@@ -63,7 +64,7 @@ void complete_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
     monitor.monitor.unlock();
 
     bool found_branch_to_explore = false;
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     for ( const int& i : random_direction_indices ) {
       const Builder::Maze::Point& p = cardinal_directions_.at( i );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
@@ -100,7 +101,7 @@ void animate_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
   Builder::Maze::Point cur = monitor.starts.at( id.index );
   std::vector<int> random_direction_indices( generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
-  std::mt19937 generator( std::random_device {}() );
+  Maze_random generator = make_maze_random();
   while ( !dfs.empty() ) {
     // Lock? Garbage read stolen mid write by winning thread is still ok for program logic.
     if ( monitor.winning_index ) {
@@ -127,7 +128,7 @@ void animate_hunt( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id )
 
     // Bias each thread's first choice towards orginal dispatch direction. More coverage.
     bool found_branch_to_explore = false;
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     for ( const int& i : random_direction_indices ) {
       const Builder::Maze::Point& p = cardinal_directions_.at( i );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
@@ -163,7 +164,7 @@ void complete_gather( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id
   Builder::Maze::Point cur = monitor.starts.at( id.index );
   std::vector<int> random_direction_indices( generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
-  std::mt19937 generator( std::random_device {}() );
+  Maze_random generator = make_maze_random();
   while ( !dfs.empty() ) {
     cur = dfs.back();
 
@@ -183,7 +184,7 @@ void complete_gather( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id
 
     // Bias each thread's first choice towards orginal dispatch direction. More coverage.
     bool found_branch_to_explore = false;
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     for ( const int& i : random_direction_indices ) {
       const Builder::Maze::Point& p = cardinal_directions_.at( i );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
@@ -214,7 +215,7 @@ void animate_gather( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id
   Builder::Maze::Point cur = monitor.starts.at( 0 );
   std::vector<int> random_direction_indices( generate_directions_.size() );
   std::iota( begin( random_direction_indices ), end( random_direction_indices ), 0 );
-  std::mt19937 generator( std::random_device {}() );
+  Maze_random generator = make_maze_random();
   while ( !dfs.empty() ) {
     cur = dfs.back();
 
@@ -232,7 +233,7 @@ void animate_gather( Builder::Maze& maze, Solver_monitor& monitor, Thread_id id
     std::this_thread::sleep_for( std::chrono::microseconds( monitor.speed.value_or( 0 ) ) );
 
     bool found_branch_to_explore = false;
-    shuffle( begin( random_direction_indices ), end( random_direction_indices ), generator );
+    generator.shuffle( random_direction_indices );
     for ( const int& i : random_direction_indices ) {
       const Builder::Maze::Point& p = cardinal_directions_.at( i );
       const Builder::Maze::Point next = { cur.row + p.row, cur.col + p.col };
@@ -327,7 +328,7 @@ void solve_with_randomized_dfs_thread_corners( Builder::Maze& maze )
 
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
     threads[i_thread] = std::thread( complete_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
@@ -423,7 +424,7 @@ void animate_with_randomized_dfs_thread_corners( Builder::Maze& maze, Solver_spe
 
   std::vector<std::thread> threads( num_threads_ );
   // Randomly shuffle thread start corners so colors mix differently each time.
-  shuffle( begin( monitor.starts ), end( monitor.starts ), std::mt19937( std::random_device {}() ) );
+  make_maze_random().shuffle( monitor.starts );
   for ( int i_thread = 0; i_thread < num_threads_; i_thread++ ) {
     const Thread_id this_thread = { i_thread, thread_masks_.at( i_thread ) };
     threads[i_thread] = std::thread( animate_hunt, std::ref( maze ), std::ref( monitor ), this_thread );
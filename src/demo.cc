@@ -1,4 +1,6 @@
+#include "living_maze.hh"
 #include "maze_algorithms.hh"
+#include "maze_random.hh"
 #include "maze_solvers.hh"
 #include "print_utilities.hh"
 #include <chrono>
@@ -6,7 +8,6 @@
 #include <functional>
 #include <iostream>
 #include <ostream>
-#include <random>
 #include <span>
 #include <thread>
 
@@ -49,10 +50,25 @@ struct Demo_runner
                                      Builder::animate_prim_maze,
                                      Builder::animate_kruskal_maze,
                                      Builder::animate_eller_maze,
+                                     Builder::animate_hunt_and_kill_maze,
+                                     []( Builder::Maze& maze, Builder::Builder_speed speed ) {
+                                       Builder::animate_growing_tree_maze(
+                                         maze, Builder::Growing_tree_policy::mix, speed );
+                                     },
+                                     Builder::animate_binary_tree_maze,
+                                     Builder::animate_sidewinder_maze,
+                                     []( Builder::Maze& maze, Builder::Builder_speed speed ) {
+                                       Builder::animate_cellular_automaton_maze(
+                                         maze, Builder::Automaton_rule::maze, speed );
+                                     },
                                      Builder::animate_grid_maze,
                                      Builder::animate_arena };
 
-  std::vector<Build_demo> modifications { Builder::add_cross_animated, Builder::add_x_animated };
+  std::vector<Build_demo> modifications { Builder::add_cross_animated,
+                                          Builder::add_x_animated,
+                                          []( Builder::Maze& maze, Builder::Builder_speed speed ) {
+                                            Builder::add_braids_animated( maze, 0.5, speed );
+                                          } };
 
   std::vector<Solver::Solver_speed> solver_speed { Solver::Solver_speed::speed_1,
                                                    Solver::Solver_speed::speed_2,
@@ -95,38 +111,43 @@ int main( int argc, char** argv )
         set_rows( demo, flags );
       } else if ( flags.flag == "-c" ) {
         set_cols( demo, flags );
+      } else if ( flags.flag == "-seed" ) {
+        seed_maze_random( std::stoull( flags.arg.data() ) );
       }
       process_current = false;
     } else {
       const std::string arg_str( arg );
-      if ( arg_str == "-r" || arg_str == "-c" ) {
+      if ( arg_str == "-r" || arg_str == "-c" || arg_str == "-seed" ) {
         flags.flag = arg;
       } else {
-        std::cerr << "The only arguments are optional row [-r] or column [-c] dimensions." << std::endl;
+        std::cerr << "The only arguments are optional row [-r] or column [-c] dimensions and a seed [-seed]."
+                  << std::endl;
         abort();
       }
       process_current = true;
     }
   }
 
-  std::mt19937 gen( std::random_device {}() );
-  std::uniform_int_distribution<uint64_t> wall_chooser( 0, demo.wall_style.size() - 1 );
-  std::uniform_int_distribution<uint64_t> builder_chooser( 0, demo.builders.size() - 1 );
-  std::uniform_int_distribution<uint64_t> speed_chooser( 0, demo.builder_speed.size() - 1 );
-  std::uniform_int_distribution<uint64_t> optional_modification( 0, 5 );
-  std::uniform_int_distribution<uint64_t> modification_chooser( 0, demo.modifications.size() - 1 );
-  std::uniform_int_distribution<uint64_t> solver_chooser( 0, demo.solvers.size() - 1 );
+  Maze_random gen = make_maze_random();
+  // Both speed tables hold speeds 1 through 7 so one draw indexes either of them.
+  const auto speed_choice = [&demo, &gen] { return gen.below( demo.builder_speed.size() ); };
   for ( ;; ) {
-    demo.args.style = demo.wall_style[wall_chooser( gen )];
+    demo.args.style = demo.wall_style[gen.below( demo.wall_style.size() )];
     Builder::Maze maze( demo.args );
-    demo.builders[builder_chooser( gen )]( maze, demo.builder_speed[speed_chooser( gen )] );
+    demo.builders[gen.below( demo.builders.size() )]( maze, demo.builder_speed[speed_choice()] );
 
-    if ( optional_modification( gen ) == 0 ) {
-      demo.modifications[modification_chooser( gen )]( maze, demo.builder_speed[speed_chooser( gen )] );
+    // A quarter of the mazes live on for a while, about one origin shift for every four cells.
+    if ( gen.below( 4 ) == 0 ) {
+      const auto cells = static_cast<uint64_t>( ( ( maze.row_size() - 1 ) / 2 ) * ( ( maze.col_size() - 1 ) / 2 ) );
+      Builder::evolve_maze_animated( maze, cells / 4, demo.builder_speed[speed_choice()] );
+    }
+
+    if ( gen.below( 6 ) == 0 ) {
+      demo.modifications[gen.below( demo.modifications.size() )]( maze, demo.builder_speed[speed_choice()] );
     }
 
     Printer::set_cursor_position( { 0, 0 } );
-    demo.solvers[solver_chooser( gen )]( maze, demo.solver_speed[speed_chooser( gen )] );
+    demo.solvers[gen.below( demo.solvers.size() )]( maze, demo.solver_speed[speed_choice()] );
 
     // We don't need loading time, it's just jarring to immediately transition after the solution finishes.
     std::cout << "Loading next maze..." << std::flush;
@@ -137,7 +158,7 @@ int main( int argc, char** argv )
 
 void set_rows( Demo_runner& runner, const Flag_arg& pairs )
 {
-  runner.args.odd_rows = std::stoi( pairs.arg.data() );
+  runner.args.odd_rows = std::stoull( pairs.arg.data() );
   if ( runner.args.odd_rows % 2 == 0 ) {
     runner.args.odd_rows++;
   }
@@ -149,7 +170,7 @@ void set_rows( Demo_runner& runner, const Flag_arg& pairs )
 
 void set_cols( Demo_runner& runner, const Flag_arg& pairs )
 {
-  runner.args.odd_cols = std::stoi( pairs.arg.data() );
+  runner.args.odd_cols = std::stoull( pairs.arg.data() );
   if ( runner.args.odd_cols % 2 == 0 ) {
     runner.args.odd_cols++;
   }
@@ -0,0 +1,240 @@
+#include "maze_algorithms.hh"
+#include "maze_solvers.hh"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+/* Compares the row major and tiled square layouts of Builder::Maze under the solvers. One maze is
+ * built, copied into each layout, and every solver plays the corners game on a fresh copy so both
+ * layouts see the exact same walls and starting points. The cache and TLB misses come from the
+ * Linux perf counters and include the solver threads. Machines that do not allow user space
+ * counters still get the wall clock times.
+ */
+
+namespace {
+
+using Solve_function = std::function<void( Builder::Maze& )>;
+
+struct Flag_arg
+{
+  std::string_view flag;
+  std::string_view arg;
+};
+
+struct Benchmark_runner
+{
+  Builder::Maze::Maze_args args { 2001, 2001, Builder::Maze::Maze_style::sharp, {}, {} };
+  int runs { 5 };
+};
+
+struct Named_solver
+{
+  std::string_view name;
+  Solve_function solve;
+};
+
+struct Named_layout
+{
+  std::string_view name;
+  Builder::Maze::Maze_layout layout;
+};
+
+enum Counter
+{
+  cache_misses = 0,
+  l1d_read_misses,
+  dtlb_read_misses,
+  counter_count,
+};
+
+struct Measurement
+{
+  double milliseconds { 0 };
+  std::array<std::optional<uint64_t>, counter_count> misses {};
+};
+
+constexpr std::array<Named_layout, 2> layouts = { {
+  { "row-major", Builder::Maze::Maze_layout::row_major },
+  { "tiled", Builder::Maze::Maze_layout::tiled },
+} };
+
+constexpr std::array<std::string_view, counter_count> counter_names = { "cache-miss", "L1d-miss", "dTLB-miss" };
+
+constexpr uint64_t hw_cache_read_miss( uint64_t cache )
+{
+  return cache | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 );
+}
+
+// Counters are opened on the calling thread before the solver spawns its threads so inherit covers them.
+int open_counter( uint32_t type, uint64_t config )
+{
+  perf_event_attr attr {};
+  attr.size = sizeof( attr );
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>( syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 ) );
+}
+
+std::array<int, counter_count> open_counters()
+{
+  return { open_counter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES ),
+           open_counter( PERF_TYPE_HW_CACHE, hw_cache_read_miss( PERF_COUNT_HW_CACHE_L1D ) ),
+           open_counter( PERF_TYPE_HW_CACHE, hw_cache_read_miss( PERF_COUNT_HW_CACHE_DTLB ) ) };
+}
+
+void copy_squares( const Builder::Maze& from, Builder::Maze& to )
+{
+  for ( int64_t row = 0; row < from.row_size(); row++ ) {
+    for ( int64_t col = 0; col < from.col_size(); col++ ) {
+      to[row][col] = from[row][col];
+    }
+  }
+}
+
+Measurement measure( const Builder::Maze& built, const Named_layout& layout, const Solve_function& solve, int runs )
+{
+  Builder::Maze::Maze_args args { static_cast<uint64_t>( built.row_size() ),
+                                  static_cast<uint64_t>( built.col_size() ),
+                                  Builder::Maze::Maze_style::sharp,
+                                  layout.layout,
+                                  {} };
+  Measurement total {};
+  for ( int run = 0; run < runs; run++ ) {
+    Builder::Maze maze( args );
+    copy_squares( built, maze );
+    const std::array<int, counter_count> counters = open_counters();
+    for ( const int fd : counters ) {
+      if ( fd >= 0 ) {
+        ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+        ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+      }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    solve( maze );
+    const auto stop = std::chrono::steady_clock::now();
+    for ( uint64_t i = 0; i < counters.size(); i++ ) {
+      if ( counters.at( i ) < 0 ) {
+        continue;
+      }
+      ioctl( counters.at( i ), PERF_EVENT_IOC_DISABLE, 0 );
+      uint64_t count = 0;
+      if ( read( counters.at( i ), &count, sizeof( count ) ) == sizeof( count ) ) {
+        total.misses.at( i ) = total.misses.at( i ).value_or( 0 ) + count;
+      }
+      close( counters.at( i ) );
+    }
+    total.milliseconds += std::chrono::duration<double, std::milli>( stop - start ).count();
+  }
+  total.milliseconds /= runs;
+  for ( std::optional<uint64_t>& misses : total.misses ) {
+    if ( misses ) {
+      misses = misses.value() / static_cast<uint64_t>( runs );
+    }
+  }
+  return total;
+}
+
+void print_measurement( std::string_view solver, std::string_view layout, const Measurement& m )
+{
+  std::cout << std::left << std::setw( 18 ) << solver << std::setw( 11 ) << layout << std::right << std::setw( 12 )
+            << std::fixed << std::setprecision( 2 ) << m.milliseconds;
+  for ( const std::optional<uint64_t>& misses : m.misses ) {
+    if ( misses ) {
+      std::cout << std::setw( 14 ) << misses.value();
+    } else {
+      std::cout << std::setw( 14 ) << "n/a";
+    }
+  }
+  std::cout << "\n";
+}
+
+void set_dimension( uint64_t& dimension, const Flag_arg& pairs )
+{
+  dimension = std::stoull( pairs.arg.data() );
+  if ( dimension % 2 == 0 ) {
+    dimension++;
+  }
+  if ( dimension < 7 ) {
+    std::cerr << "Minimum dimension may be 7." << std::endl;
+    std::abort();
+  }
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  Benchmark_runner runner;
+  const auto args = std::span( argv, static_cast<size_t>( argc ) );
+  Flag_arg flags = {};
+  for ( size_t i = 1; i < args.size(); i += 2 ) {
+    flags.flag = args[i];
+    if ( i + 1 >= args.size() ) {
+      std::cerr << "Flag " << flags.flag << " needs an argument." << std::endl;
+      std::abort();
+    }
+    flags.arg = args[i + 1];
+    if ( flags.flag == "-r" ) {
+      set_dimension( runner.args.odd_rows, flags );
+    } else if ( flags.flag == "-c" ) {
+      set_dimension( runner.args.odd_cols, flags );
+    } else if ( flags.flag == "-n" ) {
+      runner.runs = std::max( 1, std::stoi( flags.arg.data() ) );
+    } else {
+      std::cerr << "The only arguments are optional row [-r], column [-c], and run [-n] counts." << std::endl;
+      std::abort();
+    }
+  }
+
+  const std::array<Named_solver, 4> solvers = { {
+    { "dfs-corners", Solver::solve_with_dfs_thread_corners },
+    { "floodfs-corners", Solver::solve_with_floodfs_thread_corners },
+    { "rdfs-corners", Solver::solve_with_randomized_dfs_thread_corners },
+    { "bfs-corners", Solver::solve_with_bfs_thread_corners },
+  } };
+
+  // Builders and solvers draw every maze they finish. A failed stream skips all of that output.
+  std::cout.setstate( std::ios_base::badbit );
+  Builder::Maze built( runner.args );
+  Builder::generate_recursive_backtracker_maze( built );
+  std::vector<std::array<Measurement, layouts.size()>> results( solvers.size() );
+  for ( uint64_t s = 0; s < solvers.size(); s++ ) {
+    for ( uint64_t l = 0; l < layouts.size(); l++ ) {
+      results[s].at( l ) = measure( built, layouts.at( l ), solvers.at( s ).solve, runner.runs );
+    }
+  }
+  std::cout.clear();
+
+  std::cout << runner.args.odd_rows << "x" << runner.args.odd_cols << " rdfs maze, mean of " << runner.runs
+            << " runs\n";
+  std::cout << std::left << std::setw( 18 ) << "solver" << std::setw( 11 ) << "layout" << std::right
+            << std::setw( 12 ) << "ms";
+  for ( const std::string_view name : counter_names ) {
+    std::cout << std::setw( 14 ) << name;
+  }
+  std::cout << "\n";
+  for ( uint64_t s = 0; s < solvers.size(); s++ ) {
+    for ( uint64_t l = 0; l < layouts.size(); l++ ) {
+      print_measurement( solvers.at( s ).name, layouts.at( l ).name, results[s].at( l ) );
+    }
+  }
+  std::cout << std::flush;
+  return 0;
+}
@@ -1,4 +1,7 @@
+#include "living_maze.hh"
 #include "maze_algorithms.hh"
+#include "maze_file.hh"
+#include "maze_random.hh"
 #include "maze_solvers.hh"
 #include "print_utilities.hh"
 
@@ -7,8 +10,8 @@
 #include <functional>
 #include <iostream>
 #include <optional>
-#include <random>
 #include <span>
+#include <string>
 #include <string_view>
 #include <tuple>
 #include <unistd.h>
@@ -27,6 +30,51 @@ using Solve_function
 constexpr int static_image = 0;
 constexpr int animated_playback = 1;
 
+// The growing tree builders differ only in how they pick the next cell so each entry binds a policy.
+Build_function growing_tree( Builder::Growing_tree_policy policy )
+{
+  return { [policy]( Builder::Maze& maze ) { Builder::generate_growing_tree_maze( maze, policy ); },
+           [policy]( Builder::Maze& maze, Builder::Builder_speed speed ) {
+             Builder::animate_growing_tree_maze( maze, policy, speed );
+           } };
+}
+
+// Both cellular automaton builders run the same board and differ only in the rule.
+Build_function cellular_automaton( Builder::Automaton_rule rule )
+{
+  return { [rule]( Builder::Maze& maze ) { Builder::generate_cellular_automaton_maze( maze, rule ); },
+           [rule]( Builder::Maze& maze, Builder::Builder_speed speed ) {
+             Builder::animate_cellular_automaton_maze( maze, rule, speed );
+           } };
+}
+
+/* A compact builder decides every passage in two bits per cell and the finished passages are then
+ * expanded into the squares in one pass. Solvers, modifications, and saving all need the full grid
+ * so this only shows the builders at work and saves no memory here. The full grid and the passages
+ * are both alive until the expansion is done. Watching one build plays the square builder it shrinks.
+ */
+Build_function compact( const std::function<void( Builder::Passage_maze& )>& generate,
+                        const std::function<void( Builder::Maze&, Builder::Builder_speed )>& animate )
+{
+  const auto build = [generate]( Builder::Maze& maze ) {
+    Builder::Passage_maze passages(
+      { static_cast<uint64_t>( maze.row_size() ), static_cast<uint64_t>( maze.col_size() ) } );
+    generate( passages );
+    Builder::expand_passage_region( passages, maze, { 0, 0 } );
+    Builder::clear_and_flush_grid( maze );
+  };
+  return { build, animate };
+}
+
+// A braid takes the fraction of dead ends it removes so each -m braid:<fraction> binds its own.
+Build_function braid( double fraction )
+{
+  return { [fraction]( Builder::Maze& maze ) { Builder::add_braids( maze, fraction ); },
+           [fraction]( Builder::Maze& maze, Builder::Builder_speed speed ) {
+             Builder::add_braids_animated( maze, fraction, speed );
+           } };
+}
+
 struct Flag_arg
 {
   std::string_view flag;
@@ -36,14 +84,21 @@ struct Flag_arg
 struct Maze_runner
 {
   Builder::Maze::Maze_args args;
+  std::string save_file {};
+  std::string load_file {};
 
   int builder_view { static_image };
+  std::string builder_name { "rdfs" };
   Builder::Builder_speed builder_speed {};
   Build_function builder { Builder::generate_recursive_backtracker_maze,
                            Builder::animate_recursive_backtracker_maze };
 
   int modification_getter { static_image };
   std::optional<Build_function> modder {};
+  std::string modification_name {};
+
+  // Origin shifts run on the finished maze before any modification. Every shift keeps it perfect.
+  uint64_t live_shifts { 0 };
 
   int solver_view { static_image };
   Solver::Solver_speed solver_speed {};
@@ -73,21 +128,42 @@ void print_usage();
 int main( int argc, char** argv )
 {
   const Lookup_tables tables = {
-    { "-r", "-c", "-b", "-s", "-h", "-g", "-d", "-m", "-sa", "-ba" },
+    { "-r", "-c", "-b", "-s", "-h", "-g", "-d", "-m", "-sa", "-ba", "-f", "-w", "-l", "-seed", "-live" },
     {
       { "rdfs", { Builder::generate_recursive_backtracker_maze, Builder::animate_recursive_backtracker_maze } },
       { "wilson", { Builder::generate_wilson_path_carver_maze, Builder::animate_wilson_path_carver_maze } },
       { "wilson-walls", { Builder::generate_wilson_wall_adder_maze, Builder::animate_wilson_wall_adder_maze } },
+      { "wilson-parallel",
+        { Builder::generate_cycle_popping_wilson_maze, Builder::animate_wilson_path_carver_maze } },
       { "fractal", { Builder::generate_recursive_subdivision_maze, Builder::animate_recursive_subdivision_maze } },
+      { "fractal-parallel",
+        { Builder::generate_parallel_recursive_subdivision_maze, Builder::animate_recursive_subdivision_maze } },
       { "kruskal", { Builder::generate_kruskal_maze, Builder::animate_kruskal_maze } },
+      { "kruskal-parallel", { Builder::generate_parallel_kruskal_maze, Builder::animate_kruskal_maze } },
       { "eller", { Builder::generate_eller_maze, Builder::animate_eller_maze } },
       { "prim", { Builder::generate_prim_maze, Builder::animate_prim_maze } },
+      { "hunt-and-kill", { Builder::generate_hunt_and_kill_maze, Builder::animate_hunt_and_kill_maze } },
+      { "growing-tree", growing_tree( Builder::Growing_tree_policy::mix ) },
+      { "growing-tree-newest", growing_tree( Builder::Growing_tree_policy::newest ) },
+      { "growing-tree-oldest", growing_tree( Builder::Growing_tree_policy::oldest ) },
+      { "growing-tree-random", growing_tree( Builder::Growing_tree_policy::random ) },
+      { "binary-tree", { Builder::generate_binary_tree_maze, Builder::animate_binary_tree_maze } },
+      { "sidewinder", { Builder::generate_sidewinder_maze, Builder::animate_sidewinder_maze } },
+      { "automaton", cellular_automaton( Builder::Automaton_rule::maze ) },
+      { "mazectric", cellular_automaton( Builder::Automaton_rule::mazectric ) },
+      { "rdfs-compact",
+        compact(
+          []( Builder::Passage_maze& maze ) { Builder::generate_compact_recursive_backtracker_maze( maze ); },
+          Builder::animate_recursive_backtracker_maze ) },
+      { "kruskal-compact", compact( Builder::generate_compact_kruskal_maze, Builder::animate_kruskal_maze ) },
+      { "eller-compact", compact( Builder::generate_compact_eller_maze, Builder::animate_eller_maze ) },
       { "grid", { Builder::generate_grid_maze, Builder::animate_grid_maze } },
       { "arena", { Builder::generate_arena, Builder::animate_arena } },
     },
     {
       { "cross", { Builder::add_cross, Builder::add_cross_animated } },
       { "x", { Builder::add_x, Builder::add_x_animated } },
+      { "braid", braid( 1.0 ) },
     },
     {
       { "dfs-hunt", { Solver::solve_with_dfs_thread_hunt, Solver::animate_with_dfs_thread_hunt } },
@@ -164,25 +240,50 @@ int main( int argc, char** argv )
     }
   }
 
-  Builder::Maze maze( runner.args );
+  Builder::Maze maze
+    = runner.load_file.empty() ? Builder::Maze( runner.args ) : Builder::load_maze( runner.load_file, runner.args );
 
   // Functions are stored in tuples so use tuple get syntax and then call them immidiately.
 
-  if ( runner.builder_view == animated_playback ) {
+  if ( maze.is_built() ) {
+    // Loaded and remapped mazes are finished already so only an old solution needs clearing.
+    Solver::clear_solver_marks( maze );
+    Builder::clear_and_flush_grid( maze );
+  } else if ( runner.builder_view == animated_playback ) {
     std::get<animated_playback>( runner.builder )( maze, runner.builder_speed );
+    if ( runner.live_shifts ) {
+      Builder::evolve_maze_animated( maze, runner.live_shifts, runner.builder_speed );
+    }
     if ( runner.modder ) {
       std::get<animated_playback>( runner.modder.value() )( maze, runner.builder_speed );
     }
+    maze.mark_built();
   } else {
     std::get<static_image>( runner.builder )( maze );
+    if ( runner.live_shifts ) {
+      Builder::evolve_maze( maze, runner.live_shifts );
+    }
     if ( runner.modder ) {
       std::get<static_image>( runner.modder.value() )( maze );
     }
+    maze.mark_built();
+  }
+
+  if ( !runner.save_file.empty() ) {
+    std::string builder = runner.builder_name;
+    if ( runner.live_shifts ) {
+      builder += " -live " + std::to_string( runner.live_shifts );
+    }
+    if ( !runner.modification_name.empty() ) {
+      builder += " -m " + runner.modification_name;
+    }
+    Builder::save_maze( maze, runner.save_file, { builder, maze_random_seed() } );
   }
 
   // This helps ensure we have a smooth transition from build to solve with no flashing from redrawing frame.
   Printer::set_cursor_position( { 0, 0 } );
 
+  maze.advise( Builder::Maze::Access_pattern::random );
   if ( runner.solver_view == animated_playback ) {
     std::get<animated_playback>( runner.solver )( maze, runner.solver_speed );
   } else {
@@ -202,19 +303,45 @@ void set_relevant_arg( const Lookup_tables& tables, Maze_runner& runner, const F
     return;
   }
   if ( pairs.flag == "-b" ) {
-    const auto found = tables.builder_table.find( pairs.arg.data() );
+    // A builder may be followed by :threads to build that many tiles at once and stitch them together.
+    const std::string_view name = pairs.arg.substr( 0, pairs.arg.find( ':' ) );
+    const auto found = tables.builder_table.find( std::string( name ) );
     if ( found == tables.builder_table.end() ) {
       print_invalid_arg( pairs );
     }
     runner.builder = found->second;
+    runner.builder_name = pairs.arg;
+    if ( name.size() < pairs.arg.size() ) {
+      const uint64_t threads = std::stoull( std::string( pairs.arg.substr( name.size() + 1 ) ) );
+      if ( threads == 0 ) {
+        print_invalid_arg( pairs );
+      }
+      std::get<static_image>( runner.builder )
+        = [tile_builder = std::get<static_image>( found->second ), threads]( Builder::Maze& maze ) {
+            Builder::generate_tiled_maze( maze, tile_builder, threads );
+          };
+    }
     return;
   }
   if ( pairs.flag == "-m" ) {
-    const auto found = tables.modification_table.find( pairs.arg.data() );
+    // Only a braid takes an argument, the fraction of dead ends to remove, as in braid:0.5.
+    const std::string_view name = pairs.arg.substr( 0, pairs.arg.find( ':' ) );
+    const auto found = tables.modification_table.find( std::string( name ) );
     if ( found == tables.modification_table.end() ) {
       print_invalid_arg( pairs );
     }
     runner.modder = found->second;
+    runner.modification_name = pairs.arg;
+    if ( name.size() < pairs.arg.size() ) {
+      if ( name != "braid" ) {
+        print_invalid_arg( pairs );
+      }
+      const double fraction = std::stod( std::string( pairs.arg.substr( name.size() + 1 ) ) );
+      if ( !( fraction >= 0.0 && fraction <= 1.0 ) ) {
+        print_invalid_arg( pairs );
+      }
+      runner.modder = braid( fraction );
+    }
     return;
   }
   if ( pairs.flag == "-s" ) {
@@ -252,12 +379,33 @@ void set_relevant_arg( const Lookup_tables& tables, Maze_runner& runner, const F
     runner.modification_getter = animated_playback;
     return;
   }
+  if ( pairs.flag == "-f" ) {
+    runner.args.mapped_file = pairs.arg;
+    return;
+  }
+  if ( pairs.flag == "-w" ) {
+    runner.save_file = pairs.arg;
+    return;
+  }
+  if ( pairs.flag == "-l" ) {
+    runner.load_file = pairs.arg;
+    return;
+  }
+  if ( pairs.flag == "-seed" ) {
+    // Nothing random runs while flags are read so every generator made after this comes from the seed.
+    seed_maze_random( std::stoull( pairs.arg.data() ) );
+    return;
+  }
+  if ( pairs.flag == "-live" ) {
+    runner.live_shifts = std::stoull( pairs.arg.data() );
+    return;
+  }
   print_invalid_arg( pairs );
 }
 
 void set_rows( Maze_runner& runner, const Flag_arg& pairs )
 {
-  runner.args.odd_rows = std::stoi( pairs.arg.data() );
+  runner.args.odd_rows = std::stoull( pairs.arg.data() );
   if ( runner.args.odd_rows % 2 == 0 ) {
     runner.args.odd_rows++;
   }
@@ -267,7 +415,7 @@ void set_rows( Maze_runner& runner, const Flag_arg& pairs )
 }
 void set_cols( Maze_runner& runner, const Flag_arg& pairs )
 {
-  runner.args.odd_cols = std::stoi( pairs.arg.data() );
+  runner.args.odd_cols = std::stoull( pairs.arg.data() );
   if ( runner.args.odd_cols % 2 == 0 ) {
     runner.args.odd_cols++;
   }
@@ -300,16 +448,31 @@ void print_usage()
                "│ │ │   │ -b Builder flag. Set maze building algorithm.   │ │ │ │   │ │\n"
                "│ │ └─┐ ╵ │ rdfs - Randomized Depth First Search.         │ │ └─┘ ┌─┘ │\n"
                "│     │   │ kruskal - Randomized Kruskal's algorithm. │   │       │   │\n"
+               "│     │   │ kruskal-parallel - Kruskal's, all cores.  │   │       │   │\n"
                "├─────┤ ╷ ╵ prim - Randomized Prim's algorithm.─┴───┐ │ ┌─┴─────┬─┴─┐ │\n"
                "│     │ │   eller - Randomized Eller's algorithm.   │ │ │       │   │ │\n"
                "│     │ │   wilson - Loop-Erased Random Path Carver.│ │ │       │   │ │\n"
                "│ ┌─┐ ╵ ├─┬─wilson-walls - Loop-Erased Random Wall Adder. ┌───┐ ╵ ╷ │ │\n"
+               "│ │ │   │ │ wilson-parallel - Uniform tree on all cores.      │   │ │ │\n"
                "│ │ │   │ │ fractal - Randomized recursive subdivision. │ │   │   │ │ │\n"
+               "│ │ │   │ │ fractal-parallel - Subdivision on all cores.      │   │ │ │\n"
+               "│ │ │   │ │ hunt-and-kill - Walk, then hunt for a new start.  │   │ │ │\n"
+               "│ │ │   │ │ growing-tree - Newest or random cell grows next.  │   │ │ │\n"
+               "│ │ │   │ │ growing-tree-newest, -oldest or -random policy.   │   │ │ │\n"
+               "│ │ │   │ │ binary-tree - North or east per cell, all cores.  │   │ │ │\n"
+               "│ │ │   │ │ sidewinder - Rows of east runs, all cores.        │   │ │ │\n"
+               "│ │ │   │ │ automaton - Cellular automaton, Maze rule.        │   │ │ │\n"
+               "│ │ │   │ │ mazectric - Cellular automaton, Mazectric rule.   │   │ │ │\n"
+               "│ │ │   │ │ rdfs-compact - Two bits per cell until drawn.     │   │ │ │\n"
+               "│ │ │   │ │ kruskal-compact or eller-compact, the same.       │   │ │ │\n"
                "│ ╵ ├───┘ ╵ grid - A random grid pattern. ├─┐ │ ┌─────┤ ╵ │ ┌─┴───┤ ╵ │\n"
                "│   │       arena - Open floor with no walls. │ │     │   │ │     │   │\n"
+               "│   │       builder:threads - Build tiles at once, e.g. prim:8. │   │ │\n"
                "├─╴ ├─────-m Modification flag. Add shortcuts to the maze.┘ │ ┌─┐ └─╴ │\n"
                "│   │     │ cross - Add crossroads through the center.      │ │ │     │\n"
                "│ ┌─┘ ┌─┐ │ x - Add an x of crossing paths through center.──┘ │ └─────┤\n"
+               "│   │     │ braid - Open a wall in every dead end.          │ │ │     │\n"
+               "│   │     │ braid:fraction - Only some, e.g. braid:0.5.     │ │ │     │\n"
                "│ │   │ │ -s Solver flag. Choose the game and solver. │ │     │       │\n"
                "│ ╵ ┌─┘ │ └─dfs-hunt - Depth First Search ╴ ┌───┴─┬─┘ │ │ ┌───┴─────┐ │\n"
                "│   │   │   dfs-gather - Depth First Search │     │   │ │ │         │ │\n"
@@ -334,6 +497,16 @@ void print_usage()
                "│ │ ╵ │ ╶─┤ Any number 1-7. Speed increases with number.┌─┘ ┌─┤ ╵ │ ╶─┤\n"
                "│ │   │   -ba Builder Animation flag. Watch the maze build. │ │   │   │\n"
                "│ ├─╴ ├─┐ └─Any number 1-7. Speed increases with number.┘ ┌─┘ │ ┌─┴─┐ │\n"
+               "│ │   │ │ -f File flag. Keep the maze in a mapped file.   │   │ │   │ │\n"
+               "│ │   │ │ Any path. A built file skips to the solver. │   │   │ │   │ │\n"
+               "│ │   │ │ -w Write flag. Save the built maze to a file.   │   │ │   │ │\n"
+               "│ │   │ │ Any path. Saved mazes are small and bit packed. │   │ │   │ │\n"
+               "│ │   │ │ -l Load flag. Solve a maze saved with -w.   │   │   │ │   │ │\n"
+               "│ │   │ │ Any path. The saved dimensions are used.│   │   │   │ │   │ │\n"
+               "│ │   │ │ -seed Seed flag. Replay the same random maze.   │   │ │   │ │\n"
+               "│ │   │ │ Any number. A seed always draws the same maze.  │   │ │   │ │\n"
+               "│ │   │ │ -live Live flag. Shift the built maze in place. │   │ │   │ │\n"
+               "│ │   │ │ Any number of origin shifts. Stays perfect.     │   │ │   │ │\n"
                "│ │   │ │ -h Help flag. Make this prompt appear.  │   │   │   │ │   │ │\n"
                "│ └─┐ ╵ └─┐ No arguments.─┘ ┌───┐ └─┐ ├─╴ │ ╵ └───┤ ┌─┘ ┌─┴─╴ │ ├─╴ │ │\n"
                "│   │     -If any flags are omitted, defaults are used. │     │ │   │ │\n"
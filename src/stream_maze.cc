@@ -0,0 +1,98 @@
+#include "maze_algorithms.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/* Streams an Eller maze one row at a time to stdout or a file. Nothing but the current rows is ever
+ * held in memory so a row count of zero keeps going until the reader stops listening.
+ */
+
+namespace {
+
+struct Flag_arg
+{
+  std::string_view flag;
+  std::string_view arg;
+};
+
+struct Stream_runner
+{
+  Builder::Stream_args args {};
+  std::string out_file {};
+};
+
+void set_dimension( uint64_t& dimension, const Flag_arg& pairs, bool zero_allowed )
+{
+  dimension = std::stoull( pairs.arg.data() );
+  if ( dimension == 0 && zero_allowed ) {
+    return;
+  }
+  if ( dimension % 2 == 0 ) {
+    dimension++;
+  }
+  if ( dimension < 7 ) {
+    std::cerr << "Minimum dimension may be 7." << std::endl;
+    std::abort();
+  }
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  const std::unordered_map<std::string_view, Builder::Maze::Maze_style> styles = {
+    { "sharp", Builder::Maze::Maze_style::sharp },       { "round", Builder::Maze::Maze_style::round },
+    { "doubles", Builder::Maze::Maze_style::doubles },   { "bold", Builder::Maze::Maze_style::bold },
+    { "contrast", Builder::Maze::Maze_style::contrast }, { "spikes", Builder::Maze::Maze_style::spikes },
+  };
+  const std::unordered_map<std::string_view, Builder::Stream_format> formats = {
+    { "text", Builder::Stream_format::text },
+    { "binary", Builder::Stream_format::binary },
+  };
+
+  Stream_runner runner;
+  const auto args = std::span( argv, static_cast<size_t>( argc ) );
+  Flag_arg flags = {};
+  for ( size_t i = 1; i < args.size(); i += 2 ) {
+    flags.flag = args[i];
+    if ( i + 1 >= args.size() ) {
+      std::cerr << "Flag " << flags.flag << " needs an argument." << std::endl;
+      std::abort();
+    }
+    flags.arg = args[i + 1];
+    if ( flags.flag == "-r" ) {
+      set_dimension( runner.args.odd_rows, flags, true );
+    } else if ( flags.flag == "-c" ) {
+      set_dimension( runner.args.odd_cols, flags, false );
+    } else if ( flags.flag == "-d" && styles.contains( flags.arg ) ) {
+      runner.args.style = styles.at( flags.arg );
+    } else if ( flags.flag == "-t" && formats.contains( flags.arg ) ) {
+      runner.args.format = formats.at( flags.arg );
+    } else if ( flags.flag == "-o" ) {
+      runner.out_file = std::string( flags.arg );
+    } else {
+      std::cerr << "The only arguments are rows [-r] (0 never stops), columns [-c], draw style [-d], format [-t] "
+                   "text or binary, and output file [-o]."
+                << std::endl;
+      std::abort();
+    }
+  }
+
+  if ( runner.out_file.empty() ) {
+    std::ios::sync_with_stdio( false );
+    Builder::stream_eller_maze( std::cout, runner.args );
+    return 0;
+  }
+  std::ofstream out( runner.out_file, std::ios::binary | std::ios::trunc );
+  if ( !out ) {
+    std::cerr << "Could not open " << runner.out_file << " for writing." << std::endl;
+    std::abort();
+  }
+  Builder::stream_eller_maze( out, runner.args );
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include "maze_solvers.hh"
+#include "maze_utilities.hh"
+#include "maze_world.hh"
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/* Walks an unbounded Maze_world. A window the size of the terminal is filled from the world, drawn,
+ * and solved, then the window pans east for as many steps as asked. Only the window and the chunk
+ * cache are ever in memory no matter how far the walk goes.
+ */
+
+namespace {
+
+using Solve_function = std::function<void( Builder::Maze& )>;
+
+struct Flag_arg
+{
+  std::string_view flag;
+  std::string_view arg;
+};
+
+struct World_runner
+{
+  Builder::Maze::Maze_args window { 31, 111, Builder::Maze::Maze_style::sharp, {}, {} };
+  Builder::Maze_world::World_args world {};
+  Builder::Maze::Point origin { 0, 0 };
+  uint64_t pans { 0 };
+  Solve_function solver { Solver::solve_with_bfs_thread_hunt };
+};
+
+void set_dimension( uint64_t& dimension, const Flag_arg& pairs )
+{
+  dimension = std::stoull( pairs.arg.data() );
+  if ( dimension % 2 == 0 ) {
+    dimension++;
+  }
+  if ( dimension < 7 ) {
+    std::cerr << "Minimum dimension may be 7." << std::endl;
+    std::abort();
+  }
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  const std::unordered_map<std::string_view, Solve_function> solvers = {
+    { "dfs-hunt", Solver::solve_with_dfs_thread_hunt },
+    { "dfs-gather", Solver::solve_with_dfs_thread_gather },
+    { "dfs-corners", Solver::solve_with_dfs_thread_corners },
+    { "floodfs-hunt", Solver::solve_with_floodfs_thread_hunt },
+    { "floodfs-gather", Solver::solve_with_floodfs_thread_gather },
+    { "floodfs-corners", Solver::solve_with_floodfs_thread_corners },
+    { "rdfs-hunt", Solver::solve_with_randomized_dfs_thread_hunt },
+    { "rdfs-gather", Solver::solve_with_randomized_dfs_thread_gather },
+    { "rdfs-corners", Solver::solve_with_randomized_dfs_thread_corners },
+    { "bfs-hunt", Solver::solve_with_bfs_thread_hunt },
+    { "bfs-gather", Solver::solve_with_bfs_thread_gather },
+    { "bfs-corners", Solver::solve_with_bfs_thread_corners },
+  };
+
+  World_runner runner;
+  const auto args = std::span( argv, static_cast<size_t>( argc ) );
+  Flag_arg flags = {};
+  for ( size_t i = 1; i < args.size(); i += 2 ) {
+    flags.flag = args[i];
+    if ( i + 1 >= args.size() ) {
+      std::cerr << "Flag " << flags.flag << " needs an argument." << std::endl;
+      std::abort();
+    }
+    flags.arg = args[i + 1];
+    if ( flags.flag == "-r" ) {
+      set_dimension( runner.window.odd_rows, flags );
+    } else if ( flags.flag == "-c" ) {
+      set_dimension( runner.window.odd_cols, flags );
+    } else if ( flags.flag == "-seed" ) {
+      runner.world.seed = std::stoull( flags.arg.data() );
+    } else if ( flags.flag == "-y" ) {
+      runner.origin.row = std::stoll( flags.arg.data() );
+    } else if ( flags.flag == "-x" ) {
+      runner.origin.col = std::stoll( flags.arg.data() );
+    } else if ( flags.flag == "-p" ) {
+      runner.pans = std::stoull( flags.arg.data() );
+    } else if ( flags.flag == "-k" ) {
+      runner.world.cached_chunks = std::stoull( flags.arg.data() );
+    } else if ( flags.flag == "-s" && solvers.contains( flags.arg ) ) {
+      runner.solver = solvers.at( flags.arg );
+    } else {
+      std::cerr << "The only arguments are window rows [-r] and columns [-c], world seed [-seed], origin row [-y] "
+                   "and column [-x], east pans [-p], cached chunks [-k], and solver [-s]."
+                << std::endl;
+      std::abort();
+    }
+  }
+
+  Builder::Maze_world world( runner.world );
+  Builder::Maze window( runner.window );
+  for ( uint64_t pan = 0; pan <= runner.pans; pan++ ) {
+    const Builder::Maze::Point corner = world.fill_window( window, runner.origin );
+    Builder::clear_and_flush_grid( window );
+    runner.solver( window );
+    std::cout << "window at " << corner.row << "," << corner.col << " chunks built " << world.chunks_built()
+              << " cached " << world.chunks_cached() << "\n";
+    runner.origin.col += window.col_size() - 1;
+  }
+  std::cout << std::flush;
+  return 0;
+}
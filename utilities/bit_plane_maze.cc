@@ -0,0 +1,88 @@
+#include "bit_plane_maze.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace Solver {
+
+namespace {
+
+/* Ors the bits into every square whose plane bit is set. Whole words of squares no thread reached
+ * are skipped with one test, which is most of the maze for a hunt that ends early.
+ */
+void store_plane( Builder::Maze& maze,
+                  const std::vector<std::atomic<Bit_plane_maze::Plane_word>>& plane,
+                  uint64_t words_per_row,
+                  Builder::Maze::Square bits )
+{
+  for ( uint64_t i = 0; i < plane.size(); i++ ) {
+    Bit_plane_maze::Plane_word word = plane[i].load( std::memory_order_relaxed );
+    const uint64_t row = i / words_per_row;
+    const uint64_t first_col = ( i % words_per_row ) * Bit_plane_maze::squares_per_word_;
+    while ( word ) {
+      maze[row][first_col + static_cast<uint64_t>( std::countr_zero( word ) )] |= bits;
+      word &= word - 1;
+    }
+  }
+}
+
+} // namespace
+
+Bit_plane_maze::Bit_plane_maze( const Builder::Maze& maze )
+  : maze_row_size_( maze.row_size() )
+  , maze_col_size_( maze.col_size() )
+  , words_per_row_( ( static_cast<uint64_t>( maze.col_size() ) + squares_per_word_ - 1 ) / squares_per_word_ )
+  , path_( words_per_row_ * maze.row_size(), 0 )
+  , finish_( words_per_row_ * maze.row_size(), 0 )
+  , seen_ {}
+  , paint_ {}
+{
+  for ( uint64_t thread = 0; thread < seen_.size(); thread++ ) {
+    seen_.at( thread ) = std::vector<std::atomic<Plane_word>>( words_per_row_ * maze.row_size() );
+    paint_.at( thread ) = std::vector<std::atomic<Plane_word>>( words_per_row_ * maze.row_size() );
+  }
+  for ( int64_t row = 0; row < maze_row_size_; row++ ) {
+    const Builder::Maze::Const_row squares = maze[row];
+    for ( uint64_t w = 0; w < words_per_row_; w++ ) {
+      const uint64_t first_col = w * squares_per_word_;
+      const uint64_t last_col = std::min( first_col + squares_per_word_, static_cast<uint64_t>( maze_col_size_ ) );
+      Plane_word path = 0;
+      Plane_word finish = 0;
+      for ( uint64_t col = first_col; col < last_col; col++ ) {
+        const Plane_word square_bit = Plane_word { 1 } << ( col - first_col );
+        path |= squares[col] & Builder::Maze::path_bit_ ? square_bit : 0;
+        finish |= squares[col] & finish_bit_ ? square_bit : 0;
+      }
+      path_[( static_cast<uint64_t>( row ) * words_per_row_ ) + w] = path;
+      finish_[( static_cast<uint64_t>( row ) * words_per_row_ ) + w] = finish;
+    }
+  }
+}
+
+void Bit_plane_maze::store( Builder::Maze& maze ) const
+{
+  for ( uint64_t thread = 0; thread < seen_.size(); thread++ ) {
+    const auto paint = static_cast<Builder::Maze::Square>( thread_masks_.at( thread ) );
+    const auto seen = static_cast<Builder::Maze::Square>( paint << thread_tag_offset_ );
+    store_plane( maze, seen_.at( thread ), words_per_row_, seen );
+    store_plane( maze, paint_.at( thread ), words_per_row_, paint );
+  }
+}
+
+int64_t Bit_plane_maze::row_size() const
+{
+  return maze_row_size_;
+}
+
+int64_t Bit_plane_maze::col_size() const
+{
+  return maze_col_size_;
+}
+
+uint64_t Bit_plane_maze::words_per_row() const
+{
+  return words_per_row_;
+}
+
+} // namespace Solver
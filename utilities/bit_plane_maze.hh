@@ -0,0 +1,143 @@
+#pragma once
+#ifndef BIT_PLANE_MAZE_HH
+#define BIT_PLANE_MAZE_HH
+#include "maze.hh"
+#include "solver_utilities.hh"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Solver {
+
+/* A solver only cares about a few bits of every square: is it a path, is it a finish, and which
+ * threads have seen or painted it. The Builder::Maze packs all of that next to the wall glyph and
+ * builder bits so a solve drags whole 16 bit squares through the cache. This backend splits every
+ * concern into its own bit-plane, one bit per square, so 64 squares of a row share one word.
+ *
+ * path plane-----------one bit per square, read only during a solve.
+ * finish plane---------one bit per square, read only during a solve.
+ * seen planes----------one plane per thread. Only the owning thread writes its plane.
+ * paint planes---------one plane per thread. Only the owning thread writes its plane.
+ *
+ * Solvers may test one square at a time or read and write whole words of 64 squares, numbered
+ * row by row with words_per_row words to a row and square 0 of a word in its lowest bit.
+ *
+ * The maze is the adapter. Load the planes from a maze with its starts and finishes placed, solve
+ * on the planes, then store the thread bits back so all of the existing printing functions keep
+ * working. A load packs each square once and a store skips every plane word no thread touched, so
+ * the round trip costs one pass over the squares plus the squares a solve actually marked.
+ */
+class Bit_plane_maze
+{
+public:
+  using Plane_word = uint64_t;
+
+  explicit Bit_plane_maze( const Builder::Maze& maze );
+
+  // Adds the seen and paint bits of every thread to the maze. Nothing else in the maze changes.
+  void store( Builder::Maze& maze ) const;
+
+  int64_t row_size() const;
+  int64_t col_size() const;
+  uint64_t words_per_row() const;
+
+  bool is_path( const Builder::Maze::Point& p ) const
+  {
+    return path_[word_index( p )] & bit( p );
+  }
+
+  bool is_finish( const Builder::Maze::Point& p ) const
+  {
+    return finish_[word_index( p )] & bit( p );
+  }
+
+  bool is_seen( int thread, const Builder::Maze::Point& p ) const
+  {
+    return seen_.at( thread )[word_index( p )].load( std::memory_order_relaxed ) & bit( p );
+  }
+
+  bool is_seen_by_any( const Builder::Maze::Point& p ) const
+  {
+    const uint64_t i = word_index( p );
+    Plane_word any = 0;
+    for ( const std::vector<std::atomic<Plane_word>>& plane : seen_ ) {
+      any |= plane[i].load( std::memory_order_relaxed );
+    }
+    return any & bit( p );
+  }
+
+  // Only the owning thread writes a plane so a plain load and store is enough. No locked RMW.
+  void mark_seen( int thread, const Builder::Maze::Point& p )
+  {
+    std::atomic<Plane_word>& word = seen_.at( thread )[word_index( p )];
+    word.store( word.load( std::memory_order_relaxed ) | bit( p ), std::memory_order_relaxed );
+  }
+
+  void paint( int thread, const Builder::Maze::Point& p )
+  {
+    std::atomic<Plane_word>& word = paint_.at( thread )[word_index( p )];
+    word.store( word.load( std::memory_order_relaxed ) | bit( p ), std::memory_order_relaxed );
+  }
+
+  Plane_word path_word( uint64_t word ) const
+  {
+    return path_[word];
+  }
+
+  Plane_word finish_word( uint64_t word ) const
+  {
+    return finish_[word];
+  }
+
+  Plane_word seen_word( int thread, uint64_t word ) const
+  {
+    return seen_.at( thread )[word].load( std::memory_order_relaxed );
+  }
+
+  void mark_seen_word( int thread, uint64_t word, Plane_word squares )
+  {
+    std::atomic<Plane_word>& w = seen_.at( thread )[word];
+    w.store( w.load( std::memory_order_relaxed ) | squares, std::memory_order_relaxed );
+  }
+
+  void paint_word( int thread, uint64_t word, Plane_word squares )
+  {
+    std::atomic<Plane_word>& w = paint_.at( thread )[word];
+    w.store( w.load( std::memory_order_relaxed ) | squares, std::memory_order_relaxed );
+  }
+
+  uint64_t word_index( const Builder::Maze::Point& p ) const
+  {
+    return ( static_cast<uint64_t>( p.row ) * words_per_row_ )
+           + ( static_cast<uint64_t>( p.col ) / squares_per_word_ );
+  }
+
+  // The square held by bit square of the given word.
+  Builder::Maze::Point point( uint64_t word, uint64_t square ) const
+  {
+    return { static_cast<int64_t>( word / words_per_row_ ),
+             static_cast<int64_t>( ( ( word % words_per_row_ ) * squares_per_word_ ) + square ) };
+  }
+
+  static Plane_word bit( const Builder::Maze::Point& p )
+  {
+    return Plane_word { 1 } << ( static_cast<uint64_t>( p.col ) % squares_per_word_ );
+  }
+
+  static constexpr uint64_t squares_per_word_ = 64;
+
+private:
+  int64_t maze_row_size_;
+  int64_t maze_col_size_;
+  uint64_t words_per_row_;
+  std::vector<Plane_word> path_;
+  std::vector<Plane_word> finish_;
+  std::array<std::vector<std::atomic<Plane_word>>, num_threads_> seen_;
+  std::array<std::vector<std::atomic<Plane_word>>, num_threads_> paint_;
+};
+
+} // namespace Solver
+
+#endif
@@ -1,52 +1,123 @@
 #include "disjoint_set.hh"
+#include <limits>
 #include <numeric>
+#include <type_traits>
+#include <utility>
 
-Disjoint_set::Disjoint_set( const std::vector<uint64_t>& maze_square_ids )
-  : parent_set_( maze_square_ids.size() ), set_rank_( maze_square_ids.size(), 0 )
+namespace {
+
+// Two passes so no path needs to be remembered. The second pass points every square on it at the root.
+template<typename Set_id>
+uint64_t find_root( std::vector<Set_id>& parent_set, uint64_t p )
 {
-  for ( uint64_t elem = 0; elem < maze_square_ids.size(); elem++ ) {
-    parent_set_[elem] = elem;
+  uint64_t root = p;
+  while ( parent_set[root] != root ) {
+    root = parent_set[root];
+  }
+  while ( parent_set[p] != root ) {
+    const uint64_t next = parent_set[p];
+    parent_set[p] = static_cast<Set_id>( root );
+    p = next;
   }
+  return root;
 }
 
-Disjoint_set::Disjoint_set( uint64_t num_sets ) : parent_set_( num_sets ), set_rank_( num_sets, 0 )
+// The splitmix64 finalizer is a bijection so no two sets ever share a priority.
+uint64_t link_priority( uint64_t set )
 {
-  std::iota( begin( parent_set_ ), end( parent_set_ ), 0 );
+  set = ( set ^ ( set >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+  set = ( set ^ ( set >> 27 ) ) * 0x94d049bb133111ebULL;
+  return set ^ ( set >> 31 );
 }
 
-uint64_t Disjoint_set::find( uint64_t p )
+} // namespace
+
+Disjoint_set::Disjoint_set( const std::vector<uint64_t>& maze_square_ids ) : Disjoint_set( maze_square_ids.size() )
+{}
+
+Disjoint_set::Disjoint_set( uint64_t num_sets ) : forest_( make_forest( num_sets ) ) {}
+
+std::variant<Disjoint_set::Forest<uint32_t>, Disjoint_set::Forest<uint64_t>>
+Disjoint_set::make_forest( uint64_t num_sets )
 {
-  std::vector<uint64_t> compress_path;
-  while ( parent_set_[p] != p ) {
-    compress_path.push_back( p );
-    p = parent_set_[p];
-  }
-  while ( !compress_path.empty() ) {
-    parent_set_[compress_path.back()] = p;
-    compress_path.pop_back();
+  if ( num_sets <= std::numeric_limits<uint32_t>::max() ) {
+    Forest<uint32_t> forest { std::vector<uint32_t>( num_sets ), std::vector<uint8_t>( num_sets, 0 ) };
+    std::iota( begin( forest.parent_set ), end( forest.parent_set ), 0 );
+    return forest;
   }
-  return p;
+  Forest<uint64_t> forest { std::vector<uint64_t>( num_sets ), std::vector<uint8_t>( num_sets, 0 ) };
+  std::iota( begin( forest.parent_set ), end( forest.parent_set ), 0 );
+  return forest;
+}
+
+uint64_t Disjoint_set::find( uint64_t p )
+{
+  return std::visit( [p]( auto& forest ) { return find_root( forest.parent_set, p ); }, forest_ );
 }
 
 bool Disjoint_set::made_union( uint64_t a, uint64_t b )
 {
-  const uint64_t x = find( a );
-  const uint64_t y = find( b );
-  if ( x == y ) {
-    return false;
-  }
-  if ( set_rank_[x] > set_rank_[y] ) {
-    parent_set_[y] = x;
-  } else if ( set_rank_[x] < set_rank_[y] ) {
-    parent_set_[x] = y;
-  } else {
-    parent_set_[x] = y;
-    set_rank_[y]++;
-  }
-  return true;
+  return std::visit(
+    [a, b]( auto& forest ) {
+      using Set_id = typename std::decay_t<decltype( forest.parent_set )>::value_type;
+      const uint64_t x = find_root( forest.parent_set, a );
+      const uint64_t y = find_root( forest.parent_set, b );
+      if ( x == y ) {
+        return false;
+      }
+      if ( forest.set_rank[x] > forest.set_rank[y] ) {
+        forest.parent_set[y] = static_cast<Set_id>( x );
+      } else if ( forest.set_rank[x] < forest.set_rank[y] ) {
+        forest.parent_set[x] = static_cast<Set_id>( y );
+      } else {
+        forest.parent_set[x] = static_cast<Set_id>( y );
+        forest.set_rank[y]++;
+      }
+      return true;
+    },
+    forest_ );
 }
 
 bool Disjoint_set::is_union_no_merge( uint64_t a, uint64_t b )
 {
   return find( a ) == find( b );
 }
+
+Concurrent_disjoint_set::Concurrent_disjoint_set( uint64_t num_sets ) : parent_set_( num_sets )
+{
+  for ( uint64_t set = 0; set < num_sets; set++ ) {
+    parent_set_[set].store( set, std::memory_order_relaxed );
+  }
+}
+
+uint64_t Concurrent_disjoint_set::find( uint64_t p )
+{
+  uint64_t parent = parent_set_[p].load( std::memory_order_acquire );
+  while ( parent != p ) {
+    const uint64_t grandparent = parent_set_[parent].load( std::memory_order_acquire );
+    // Path halving. Losing this race is harmless because another thread already moved p closer to the root.
+    parent_set_[p].compare_exchange_weak( parent, grandparent, std::memory_order_acq_rel );
+    p = grandparent;
+    parent = parent_set_[p].load( std::memory_order_acquire );
+  }
+  return p;
+}
+
+bool Concurrent_disjoint_set::made_union( uint64_t a, uint64_t b )
+{
+  for ( ;; ) {
+    a = find( a );
+    b = find( b );
+    if ( a == b ) {
+      return false;
+    }
+    if ( link_priority( a ) > link_priority( b ) ) {
+      std::swap( a, b );
+    }
+    // Only a root may be linked. If a stopped being a root another thread merged it first so try again.
+    uint64_t expected = a;
+    if ( parent_set_[a].compare_exchange_strong( expected, b, std::memory_order_acq_rel ) ) {
+      return true;
+    }
+  }
+}
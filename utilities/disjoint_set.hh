@@ -1,7 +1,9 @@
 #ifndef DISJOINT_SET_HH
 #define DISJOINT_SET_HH
 
+#include <atomic>
 #include <cstdint>
+#include <variant>
 #include <vector>
 
 class Disjoint_set
@@ -14,8 +16,38 @@ public:
   bool is_union_no_merge( uint64_t a, uint64_t b );
 
 private:
-  std::vector<uint64_t> parent_set_;
-  std::vector<uint64_t> set_rank_;
+  /* Ids are always 64 bit at the interface but most mazes have far fewer than four billion cells so
+   * parents are stored in 32 bits unless the set count needs more. A rank never exceeds log2 of the
+   * set count so one byte holds any rank.
+   */
+  template<typename Set_id>
+  struct Forest
+  {
+    std::vector<Set_id> parent_set;
+    std::vector<uint8_t> set_rank;
+  };
+
+  std::variant<Forest<uint32_t>, Forest<uint64_t>> forest_;
+
+  static std::variant<Forest<uint32_t>, Forest<uint64_t>> make_forest( uint64_t num_sets );
+};
+
+/* A union-find many threads may call at once without locks. A root is linked with one compare and
+ * swap of its parent so two threads racing to merge the same sets have exactly one winner, and
+ * made_union reports true only to that winner. Finds halve the path as they go, also with compare
+ * and swap, so a lost race only means a path was not shortened. Ranks would need a second word per
+ * set so roots are linked by a fixed pseudo random priority of their ids, which keeps trees shallow
+ * like random ranks do.
+ */
+class Concurrent_disjoint_set
+{
+public:
+  explicit Concurrent_disjoint_set( uint64_t num_sets );
+  uint64_t find( uint64_t p );
+  bool made_union( uint64_t a, uint64_t b );
+
+private:
+  std::vector<std::atomic<uint64_t>> parent_set_;
 };
 
 #endif
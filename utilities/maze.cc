@@ -1,40 +1,222 @@
 #include "maze.hh"
 
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <thread>
+#include <unistd.h>
 #include <vector>
 
 namespace Builder {
 
+namespace {
+
+constexpr std::array<char, 8> mapped_magic_ = { 'M', 'A', 'Z', 'E', 'S', 'Q', 'R', '2' };
+
+struct Mapped_header
+{
+  std::array<char, 8> magic;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t layout;
+  uint64_t built;
+};
+
+uint64_t round_up( uint64_t n, uint64_t multiple )
+{
+  return ( n + multiple - 1 ) / multiple * multiple;
+}
+
+uint64_t square_count( uint64_t rows, uint64_t cols, Maze::Maze_layout layout )
+{
+  if ( layout == Maze::Maze_layout::tiled ) {
+    return round_up( rows, Maze::tile_width_ ) * round_up( cols, Maze::tile_width_ );
+  }
+  return rows * round_up( cols, Maze::squares_per_cache_line_ );
+}
+
+/* Row major rows start on a fresh cache line. Tiles are laid out row major and so are the squares
+ * in a tile, so a band of tile_width_ rows spans every tile across the maze.
+ */
+uint64_t row_stride_for( uint64_t cols, Maze::Maze_layout layout )
+{
+  if ( layout == Maze::Maze_layout::tiled ) {
+    return round_up( cols, Maze::tile_width_ ) * Maze::tile_width_;
+  }
+  return round_up( cols, Maze::squares_per_cache_line_ );
+}
+
+[[noreturn]] void abort_mapping( const std::string& file, std::string_view what )
+{
+  std::cerr << "Could not map maze file " << file << ": " << what << " (" << std::strerror( errno ) << ")"
+            << std::endl;
+  std::abort();
+}
+
+Mapped_header* header_of( Maze::Square* squares )
+{
+  return reinterpret_cast<Mapped_header*>( reinterpret_cast<char*>( squares ) - Maze::mapped_header_bytes_ );
+}
+
+} // namespace
+
+void Maze::Square_release::operator()( Square* squares ) const
+{
+  if ( mapped_bytes ) {
+    munmap( header_of( squares ), mapped_bytes );
+    return;
+  }
+  ::operator delete[]( squares, std::align_val_t { cache_line_bytes_ } );
+}
+
 Maze::Maze( const Maze_args& args )
-  : maze_row_size_( static_cast<int>( args.odd_rows ) )
-  , maze_col_size_( static_cast<int>( args.odd_cols ) )
-  , maze_( maze_row_size_, std::vector<Square>( maze_col_size_, 0 ) )
+  : Maze( args, args.mapped_file.empty() ? allocate_heap( args ) : map_file( args ) )
+{}
+
+Maze::Maze( const Maze_args& args, Storage storage )
+  : maze_row_size_( static_cast<int64_t>( storage.rows ) )
+  , maze_col_size_( static_cast<int64_t>( storage.cols ) )
+  , layout_( storage.layout )
+  , row_stride_( row_stride_for( storage.cols, storage.layout ) )
+  , maze_( std::move( storage.squares ) )
   , wall_style_index_( static_cast<int>( args.style ) )
+  , built_( storage.built )
 {}
 
-std::vector<Maze::Square>& Maze::operator[]( uint64_t index )
+Maze::Storage Maze::allocate_heap( const Maze_args& args )
+{
+  const uint64_t count = square_count( args.odd_rows, args.odd_cols, args.layout );
+  auto* squares
+    = static_cast<Square*>( ::operator new[]( count * sizeof( Square ), std::align_val_t { cache_line_bytes_ } ) );
+  std::fill( squares, squares + count, Square { 0 } );
+  return { args.odd_rows,
+           args.odd_cols,
+           args.layout,
+           std::unique_ptr<Square[], Square_release>( squares, Square_release {} ),
+           false };
+}
+
+/* A file with a valid header is reused as is and keeps the dimensions it was built with. Anything
+ * else is truncated to zero and regrown so the builders start from the zeroed squares they expect.
+ */
+Maze::Storage Maze::map_file( const Maze_args& args )
+{
+  const int fd = open( args.mapped_file.c_str(), O_RDWR | O_CREAT, 0644 );
+  if ( fd < 0 ) {
+    abort_mapping( args.mapped_file, "open failed" );
+  }
+  struct stat info {};
+  if ( fstat( fd, &info ) ) {
+    abort_mapping( args.mapped_file, "stat failed" );
+  }
+  Mapped_header header {};
+  const auto file_bytes = static_cast<uint64_t>( info.st_size );
+  bool reuse = file_bytes >= mapped_header_bytes_ && pread( fd, &header, sizeof( header ), 0 ) == sizeof( header )
+               && header.magic == mapped_magic_ && header.layout <= static_cast<uint64_t>( Maze_layout::tiled );
+  const auto layout = static_cast<Maze_layout>( header.layout );
+  reuse = reuse
+          && file_bytes
+               == mapped_header_bytes_ + ( square_count( header.rows, header.cols, layout ) * sizeof( Square ) );
+  if ( !reuse ) {
+    header = { mapped_magic_, args.odd_rows, args.odd_cols, static_cast<uint64_t>( args.layout ), 0 };
+  }
+  const uint64_t count = square_count( header.rows, header.cols, static_cast<Maze_layout>( header.layout ) );
+  const uint64_t bytes = mapped_header_bytes_ + ( count * sizeof( Square ) );
+  if ( !reuse && ( ftruncate( fd, 0 ) || ftruncate( fd, static_cast<off_t>( bytes ) ) ) ) {
+    abort_mapping( args.mapped_file, "resize failed" );
+  }
+  void* mapping = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+  close( fd );
+  if ( mapping == MAP_FAILED ) {
+    abort_mapping( args.mapped_file, "mmap failed" );
+  }
+  auto* squares = reinterpret_cast<Square*>( static_cast<char*>( mapping ) + mapped_header_bytes_ );
+  *header_of( squares ) = header;
+  // A half built maze left behind by an interrupted run must start from zeroed squares again.
+  if ( reuse && !header.built ) {
+    madvise( mapping, bytes, MADV_SEQUENTIAL );
+    std::fill( squares, squares + count, Square { 0 } );
+  }
+  return { header.rows,
+           header.cols,
+           static_cast<Maze_layout>( header.layout ),
+           std::unique_ptr<Square[], Square_release>( squares, Square_release { bytes } ),
+           header.built != 0 };
+}
+
+Maze::Row Maze::at( uint64_t row )
 {
-  return maze_.at( index );
+  if ( row >= static_cast<uint64_t>( maze_row_size_ ) ) {
+    throw std::out_of_range( "Maze row " + std::to_string( row ) + " is out of range." );
+  }
+  return { maze_.get() + row_offset( row ),
+           static_cast<uint64_t>( maze_col_size_ ),
+           layout_ == Maze_layout::tiled };
 }
 
-const std::vector<Maze::Square>& Maze::operator[]( uint64_t index ) const
+Maze::Const_row Maze::at( uint64_t row ) const
 {
-  return maze_.at( index );
+  if ( row >= static_cast<uint64_t>( maze_row_size_ ) ) {
+    throw std::out_of_range( "Maze row " + std::to_string( row ) + " is out of range." );
+  }
+  return { maze_.get() + row_offset( row ),
+           static_cast<uint64_t>( maze_col_size_ ),
+           layout_ == Maze_layout::tiled };
 }
 
-int Maze::row_size() const
+int64_t Maze::row_size() const
 {
   return maze_row_size_;
 }
 
-int Maze::col_size() const
+int64_t Maze::col_size() const
 {
   return maze_col_size_;
 }
 
+Maze::Maze_layout Maze::layout() const
+{
+  return layout_;
+}
+
+bool Maze::is_mapped() const
+{
+  return maze_.get_deleter().mapped_bytes != 0;
+}
+
+bool Maze::is_built() const
+{
+  return built_;
+}
+
+void Maze::mark_built()
+{
+  built_ = true;
+  if ( !is_mapped() ) {
+    return;
+  }
+  header_of( maze_.get() )->built = 1;
+  msync( header_of( maze_.get() ), mapped_header_bytes_, MS_ASYNC );
+}
+
+void Maze::advise( Access_pattern pattern ) const
+{
+  if ( !is_mapped() ) {
+    return;
+  }
+  madvise( header_of( maze_.get() ),
+           maze_.get_deleter().mapped_bytes,
+           pattern == Access_pattern::sequential ? MADV_SEQUENTIAL : MADV_RANDOM );
+}
+
 const std::array<std::string_view, 16>& Maze::wall_style() const
 {
   return wall_styles_.at( wall_style_index_ );
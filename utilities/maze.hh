@@ -2,8 +2,13 @@
 #define MAZE_HH
 
 #include <array>
+#include <bit>
 #include <cmath>
 #include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
@@ -34,8 +39,20 @@ public:
 
   struct Point
   {
-    int row;
-    int col;
+    int64_t row;
+    int64_t col;
+  };
+
+  enum class Access_pattern
+  {
+    sequential,
+    random,
+  };
+
+  enum class Maze_layout
+  {
+    row_major,
+    tiled,
   };
 
   struct Maze_args
@@ -43,6 +60,9 @@ public:
     uint64_t odd_rows = 31;
     uint64_t odd_cols = 111;
     Maze_style style = Maze_style::sharp;
+    Maze_layout layout = Maze_layout::row_major;
+    // When set the squares live in this memory mapped file instead of on the heap.
+    std::string mapped_file {};
   };
 
   /* Here is the scheme we will use to store tons of data in a square.
@@ -92,14 +112,111 @@ public:
   using Wall_line = uint16_t;
   using Backtrack_marker = uint16_t;
 
+  /* A row is where the row starts in the buffer and whether the maze is tiled. Row major squares
+   * follow each other so a column is a plain index. Tiled rows hop to the next tile every
+   * tile_width_ squares, which is a shift and a mask because the width is a power of two.
+   * Builders and solvers only ever write maze[row][col] so they work with either layout.
+   */
+  template<typename Square_type>
+  class Basic_row
+  {
+  public:
+    Basic_row( Square_type* row_start, uint64_t cols, bool tiled, uint64_t first_col = 0 )
+      : row_start_( row_start ), first_col_( first_col ), cols_( cols ), tiled_( tiled )
+    {}
+
+    Square_type& operator[]( uint64_t col ) const
+    {
+#ifdef MAZE_CHECKED_ACCESS
+      return at( col );
+#else
+      return tiled_ ? row_start_[tiled_offset( first_col_ + col )] : row_start_[col];
+#endif
+    }
+
+    Square_type& at( uint64_t col ) const
+    {
+      if ( col >= cols_ ) {
+        throw std::out_of_range( "Maze column " + std::to_string( col ) + " is out of range." );
+      }
+      return tiled_ ? row_start_[tiled_offset( first_col_ + col )] : row_start_[col];
+    }
+
+    uint64_t size() const
+    {
+      return cols_;
+    }
+
+    // The count columns starting at first. A row major slice starts later and a tiled one counts from first.
+    Basic_row slice( uint64_t first, uint64_t count ) const
+    {
+      return tiled_ ? Basic_row { row_start_, count, true, first_col_ + first }
+                    : Basic_row { row_start_ + first, count, false };
+    }
+
+  private:
+    Square_type* row_start_;
+    // Only tiled slices use this. A row major slice moves its start instead.
+    uint64_t first_col_;
+    uint64_t cols_;
+    bool tiled_;
+
+    static uint64_t tiled_offset( uint64_t col )
+    {
+      return ( ( col >> tile_shift_ ) * tile_squares_ ) | ( col & tile_mask_ );
+    }
+  };
+
+  using Row = Basic_row<Square>;
+  using Const_row = Basic_row<const Square>;
+
   explicit Maze( const Maze_args& args );
 
-  std::vector<Square>& operator[]( uint64_t index );
-  const std::vector<Square>& operator[]( uint64_t index ) const;
-  int row_size() const;
-  int col_size() const;
+  /* Squares live in one cache line aligned buffer. Row major rows start on a fresh cache line so
+   * the stride may be a little wider than the number of columns. Tiled mazes store square blocks of
+   * tile_width_ squares per side so a step north or south stays in the same few pages. The
+   * subscript operator is the hot path for every builder and solver so it does not check bounds
+   * unless the build was configured with MAZE_CHECKED_ACCESS. Use at() when a check is always wanted.
+   */
+  Row operator[]( uint64_t row )
+  {
+#ifdef MAZE_CHECKED_ACCESS
+    return at( row );
+#else
+    return { maze_.get() + row_offset( row ),
+             static_cast<uint64_t>( maze_col_size_ ),
+             layout_ == Maze_layout::tiled };
+#endif
+  }
+
+  Const_row operator[]( uint64_t row ) const
+  {
+#ifdef MAZE_CHECKED_ACCESS
+    return at( row );
+#else
+    return { maze_.get() + row_offset( row ),
+             static_cast<uint64_t>( maze_col_size_ ),
+             layout_ == Maze_layout::tiled };
+#endif
+  }
+
+  Row at( uint64_t row );
+  Const_row at( uint64_t row ) const;
+  int64_t row_size() const;
+  int64_t col_size() const;
+  Maze_layout layout() const;
   const std::array<std::string_view, 16>& wall_style() const;
 
+  /* A mapped maze keeps its squares in a file so it may be larger than memory and it outlives the
+   * process. A file that already holds a finished maze is reopened with its own dimensions and
+   * reports is_built() so the caller can skip straight to solving. Access hints are only passed on
+   * to the kernel for mapped mazes and are free to call otherwise.
+   */
+  bool is_mapped() const;
+  bool is_built() const;
+  void mark_built();
+  void advise( Access_pattern pattern ) const;
+
   static constexpr Square path_bit_ = 0b0010'0000'0000'0000;
   static constexpr Square clear_available_bits_ = 0b0001'1111'1111'0000;
   static constexpr Square start_bit_ = 0b0100'0000'0000'0000;
@@ -150,11 +267,53 @@ public:
   static constexpr std::array<Point, 8> all_directions_
     = { { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } } };
 
+  static constexpr uint64_t cache_line_bytes_ = 64;
+  static constexpr uint64_t squares_per_cache_line_ = cache_line_bytes_ / sizeof( Square );
+  // One row of a tile is exactly one cache line and the tile width is a power of two.
+  static constexpr uint64_t tile_shift_ = std::countr_zero( squares_per_cache_line_ );
+  static constexpr uint64_t tile_width_ = uint64_t { 1 } << tile_shift_;
+  static constexpr uint64_t tile_mask_ = tile_width_ - 1;
+  static constexpr uint64_t tile_squares_ = tile_width_ * tile_width_;
+
+  static constexpr uint64_t mapped_header_bytes_ = 4096;
+
 private:
-  int maze_row_size_;
-  int maze_col_size_;
-  std::vector<std::vector<Square>> maze_;
+  // Heap squares have no mapped bytes. Mapped squares sit one header page into the mapping.
+  struct Square_release
+  {
+    uint64_t mapped_bytes { 0 };
+    void operator()( Square* squares ) const;
+  };
+
+  struct Storage
+  {
+    uint64_t rows;
+    uint64_t cols;
+    Maze_layout layout;
+    std::unique_ptr<Square[], Square_release> squares;
+    bool built;
+  };
+
+  Maze( const Maze_args& args, Storage storage );
+  static Storage allocate_heap( const Maze_args& args );
+  static Storage map_file( const Maze_args& args );
+
+  uint64_t row_offset( uint64_t row ) const
+  {
+    if ( layout_ == Maze_layout::tiled ) {
+      return ( ( row >> tile_shift_ ) * row_stride_ ) + ( ( row & tile_mask_ ) << tile_shift_ );
+    }
+    return row * row_stride_;
+  }
+
+  int64_t maze_row_size_;
+  int64_t maze_col_size_;
+  Maze_layout layout_;
+  // Squares from one row to the next in row major order, or from one band of tiles to the next.
+  uint64_t row_stride_;
+  std::unique_ptr<Square[], Square_release> maze_;
   int wall_style_index_;
+  bool built_;
 };
 
 bool operator==( const Maze::Point& lhs, const Builder::Maze::Point& rhs );
@@ -169,7 +328,7 @@ struct hash<Builder::Maze::Point>
 {
   inline size_t operator()( const Builder::Maze::Point& p ) const
   {
-    const std::hash<int> hasher;
+    const std::hash<int64_t> hasher;
     return hasher( p.row ) ^ hasher( p.col );
   }
 };
@@ -0,0 +1,350 @@
+#include "maze_file.hh"
+#include "passage_maze.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace Builder {
+
+namespace {
+
+constexpr std::array<char, 8> maze_file_magic_ = { 'M', 'A', 'Z', 'E', 'B', 'I', 'N', '1' };
+constexpr uint32_t maze_file_version_ = 1;
+constexpr uint64_t word_bits_ = 64;
+constexpr uint64_t max_literal_run_ = 128;
+constexpr uint64_t max_repeat_run_ = 128;
+
+static_assert( sizeof( Maze_file_header ) % sizeof( uint64_t ) == 0, "Payload words must stay aligned." );
+
+// The read only mapping of a whole file. The payload words are read from here in place.
+class Mapped_file
+{
+public:
+  explicit Mapped_file( const std::string& path );
+  ~Mapped_file();
+  Mapped_file( const Mapped_file& ) = delete;
+  Mapped_file& operator=( const Mapped_file& ) = delete;
+  Mapped_file( Mapped_file&& ) = delete;
+  Mapped_file& operator=( Mapped_file&& ) = delete;
+
+  std::span<const uint8_t> bytes() const
+  {
+    return { static_cast<const uint8_t*>( mapping_ ), size_ };
+  }
+
+private:
+  uint64_t size_;
+  void* mapping_;
+};
+
+[[noreturn]] void abort_maze_file( const std::string& path, std::string_view what )
+{
+  std::cerr << "Maze file " << path << ": " << what << std::endl;
+  std::abort();
+}
+
+Mapped_file::Mapped_file( const std::string& path ) : size_( 0 ), mapping_( MAP_FAILED )
+{
+  const int fd = open( path.c_str(), O_RDONLY );
+  if ( fd < 0 ) {
+    abort_maze_file( path, std::strerror( errno ) );
+  }
+  struct stat info {};
+  if ( fstat( fd, &info ) || info.st_size < static_cast<off_t>( sizeof( Maze_file_header ) ) ) {
+    close( fd );
+    abort_maze_file( path, "too small to hold a maze header" );
+  }
+  size_ = static_cast<uint64_t>( info.st_size );
+  mapping_ = mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+  if ( mapping_ == MAP_FAILED ) {
+    abort_maze_file( path, std::strerror( errno ) );
+  }
+  madvise( mapping_, size_, MADV_SEQUENTIAL );
+}
+
+Mapped_file::~Mapped_file()
+{
+  if ( mapping_ != MAP_FAILED ) {
+    munmap( mapping_, size_ );
+  }
+}
+
+bool is_path( const Maze& maze, int64_t row, int64_t col )
+{
+  return maze[row][col] & Maze::path_bit_;
+}
+
+// Passages can only describe a maze whose cells are all open and whose wall corners are all walls.
+bool fits_passage_encoding( const Maze& maze )
+{
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+      const bool border = row == 0 || col == 0 || row == maze.row_size() - 1 || col == maze.col_size() - 1;
+      if ( ( border || ( row % 2 == 0 && col % 2 == 0 ) ) && is_path( maze, row, col ) ) {
+        return false;
+      }
+      if ( row % 2 && col % 2 && !is_path( maze, row, col ) ) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<uint64_t> pack_passages( const Maze& maze )
+{
+  Passage_maze passages( { static_cast<uint64_t>( maze.row_size() ), static_cast<uint64_t>( maze.col_size() ) } );
+  for ( uint64_t row = 0; row < passages.cell_rows(); row++ ) {
+    for ( uint64_t col = 0; col < passages.cell_cols(); col++ ) {
+      const auto square_row = static_cast<int64_t>( ( 2 * row ) + 1 );
+      const auto square_col = static_cast<int64_t>( ( 2 * col ) + 1 );
+      if ( col + 1 < passages.cell_cols() && is_path( maze, square_row, square_col + 1 ) ) {
+        passages.open_east( { row, col } );
+      }
+      if ( row + 1 < passages.cell_rows() && is_path( maze, square_row + 1, square_col ) ) {
+        passages.open_south( { row, col } );
+      }
+    }
+  }
+  return { passages.words().begin(), passages.words().end() };
+}
+
+std::vector<uint64_t> pack_squares( const Maze& maze )
+{
+  const auto cols = static_cast<uint64_t>( maze.col_size() );
+  const uint64_t squares = static_cast<uint64_t>( maze.row_size() ) * cols;
+  std::vector<uint64_t> words( ( squares + word_bits_ - 1 ) / word_bits_ );
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+      if ( is_path( maze, row, col ) ) {
+        const uint64_t bit = ( static_cast<uint64_t>( row ) * cols ) + static_cast<uint64_t>( col );
+        words[bit / word_bits_] |= uint64_t { 1 } << ( bit % word_bits_ );
+      }
+    }
+  }
+  return words;
+}
+
+/* PackBits style run length encoding. A control byte below 128 is followed by that many plus one
+ * literal bytes. A control byte of 128 or more repeats the next byte control - 126 times.
+ */
+std::vector<uint8_t> compress( std::span<const uint8_t> raw )
+{
+  std::vector<uint8_t> packed {};
+  uint64_t i = 0;
+  while ( i < raw.size() ) {
+    uint64_t run = 1;
+    while ( i + run < raw.size() && run < max_repeat_run_ && raw[i + run] == raw[i] ) {
+      run++;
+    }
+    if ( run > 1 ) {
+      packed.push_back( static_cast<uint8_t>( run + 126 ) );
+      packed.push_back( raw[i] );
+      i += run;
+      continue;
+    }
+    uint64_t literal = 0;
+    while ( i + literal < raw.size() && literal < max_literal_run_
+            && ( i + literal + 1 >= raw.size() || raw[i + literal] != raw[i + literal + 1] ) ) {
+      literal++;
+    }
+    literal = std::max( literal, uint64_t { 1 } );
+    packed.push_back( static_cast<uint8_t>( literal - 1 ) );
+    const auto first = raw.begin() + static_cast<int64_t>( i );
+    packed.insert( packed.end(), first, first + static_cast<int64_t>( literal ) );
+    i += literal;
+  }
+  return packed;
+}
+
+std::vector<uint64_t> decompress( const std::string& path, std::span<const uint8_t> packed, uint64_t raw_bytes )
+{
+  std::vector<uint64_t> words( ( raw_bytes + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t ) );
+  auto* raw = reinterpret_cast<uint8_t*>( words.data() );
+  uint64_t out = 0;
+  uint64_t i = 0;
+  while ( i < packed.size() ) {
+    const uint8_t control = packed[i++];
+    if ( control < max_literal_run_ ) {
+      const uint64_t literal = control + 1ULL;
+      if ( i + literal > packed.size() || out + literal > raw_bytes ) {
+        abort_maze_file( path, "compressed payload is corrupt" );
+      }
+      std::copy_n( packed.begin() + static_cast<int64_t>( i ), literal, raw + out );
+      i += literal;
+      out += literal;
+    } else {
+      const uint64_t run = control - 126ULL;
+      if ( i >= packed.size() || out + run > raw_bytes ) {
+        abort_maze_file( path, "compressed payload is corrupt" );
+      }
+      std::fill_n( raw + out, run, packed[i++] );
+      out += run;
+    }
+  }
+  if ( out != raw_bytes ) {
+    abort_maze_file( path, "compressed payload is truncated" );
+  }
+  return words;
+}
+
+bool is_bit_set( std::span<const uint64_t> words, uint64_t bit )
+{
+  return ( words[bit / word_bits_] >> ( bit % word_bits_ ) ) & 1;
+}
+
+// Mirrors the Passage_maze layout so passages are read from the file without building one.
+bool is_open_passage_square( std::span<const uint64_t> words,
+                             const Maze_file_header& header,
+                             int64_t row,
+                             int64_t col )
+{
+  const auto r = static_cast<uint64_t>( row );
+  const auto c = static_cast<uint64_t>( col );
+  if ( r == 0 || c == 0 || r >= header.rows - 1 || c >= header.cols - 1 ) {
+    return false;
+  }
+  const uint64_t cell_cols = ( header.cols - 1 ) / 2;
+  if ( r % 2 && c % 2 ) {
+    return true;
+  }
+  if ( r % 2 ) {
+    const uint64_t cell = ( ( r / 2 ) * cell_cols ) + ( c / 2 ) - 1;
+    return is_bit_set( words, ( cell * Passage_maze::passage_bits_ ) + 0 );
+  }
+  if ( c % 2 ) {
+    const uint64_t cell = ( ( ( r / 2 ) - 1 ) * cell_cols ) + ( c / 2 );
+    return is_bit_set( words, ( cell * Passage_maze::passage_bits_ ) + 1 );
+  }
+  return false;
+}
+
+bool is_open_square( std::span<const uint64_t> words, const Maze_file_header& header, int64_t row, int64_t col )
+{
+  if ( header.encoding == Maze_encoding::passages ) {
+    return is_open_passage_square( words, header, row, col );
+  }
+  return is_bit_set( words, ( static_cast<uint64_t>( row ) * header.cols ) + static_cast<uint64_t>( col ) );
+}
+
+bool is_wall_square( std::span<const uint64_t> words, const Maze_file_header& header, int64_t row, int64_t col )
+{
+  return row >= 0 && col >= 0 && static_cast<uint64_t>( row ) < header.rows
+         && static_cast<uint64_t>( col ) < header.cols && !is_open_square( words, header, row, col );
+}
+
+void expand_payload( std::span<const uint64_t> words, const Maze_file_header& header, Maze& maze )
+{
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+      if ( !is_wall_square( words, header, row, col ) ) {
+        maze[row][col] = Maze::path_bit_ | Maze::builder_bit_;
+        continue;
+      }
+      Maze::Wall_line wall = 0b0;
+      if ( is_wall_square( words, header, row - 1, col ) ) {
+        wall |= Maze::north_wall_;
+      }
+      if ( is_wall_square( words, header, row, col + 1 ) ) {
+        wall |= Maze::east_wall_;
+      }
+      if ( is_wall_square( words, header, row + 1, col ) ) {
+        wall |= Maze::south_wall_;
+      }
+      if ( is_wall_square( words, header, row, col - 1 ) ) {
+        wall |= Maze::west_wall_;
+      }
+      maze[row][col] = static_cast<Maze::Square>( wall | Maze::builder_bit_ );
+    }
+  }
+}
+
+} // namespace
+
+void save_maze( const Maze& maze, const std::string& path, const Maze_file_info& info )
+{
+  Maze_file_header header {};
+  header.magic = maze_file_magic_;
+  header.version = maze_file_version_;
+  header.encoding = fits_passage_encoding( maze ) ? Maze_encoding::passages : Maze_encoding::squares;
+  header.rows = static_cast<uint64_t>( maze.row_size() );
+  header.cols = static_cast<uint64_t>( maze.col_size() );
+  header.seed = info.seed;
+  // The builder name always keeps at least one null byte at the end.
+  std::copy_n(
+    info.builder.begin(), std::min( info.builder.size(), header.builder.size() - 1 ), header.builder.begin() );
+
+  const std::vector<uint64_t> words
+    = header.encoding == Maze_encoding::passages ? pack_passages( maze ) : pack_squares( maze );
+  const std::span<const uint8_t> raw( reinterpret_cast<const uint8_t*>( words.data() ),
+                                      words.size() * sizeof( uint64_t ) );
+  const std::vector<uint8_t> packed = compress( raw );
+  header.compressed = packed.size() < raw.size();
+  header.raw_bytes = raw.size();
+  header.payload_bytes = header.compressed ? packed.size() : raw.size();
+
+  std::ofstream out( path, std::ios::binary | std::ios::trunc );
+  out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+  if ( header.compressed ) {
+    out.write( reinterpret_cast<const char*>( packed.data() ), static_cast<std::streamsize>( packed.size() ) );
+  } else {
+    out.write( reinterpret_cast<const char*>( raw.data() ), static_cast<std::streamsize>( raw.size() ) );
+  }
+  if ( !out ) {
+    abort_maze_file( path, "could not be written" );
+  }
+}
+
+Maze load_maze( const std::string& path, Maze::Maze_args args )
+{
+  const Mapped_file file( path );
+  const std::span<const uint8_t> bytes = file.bytes();
+  Maze_file_header header {};
+  std::memcpy( &header, bytes.data(), sizeof( header ) );
+  if ( header.magic != maze_file_magic_ || header.version != maze_file_version_ ) {
+    abort_maze_file( path, "is not a maze file this version can read" );
+  }
+  if ( header.rows < 3 || header.cols < 3 || header.rows % 2 == 0 || header.cols % 2 == 0
+       || header.payload_bytes != bytes.size() - sizeof( header ) ) {
+    abort_maze_file( path, "has a corrupt header" );
+  }
+  const uint64_t cells = ( ( header.rows - 1 ) / 2 ) * ( ( header.cols - 1 ) / 2 );
+  const uint64_t needed_bits
+    = header.encoding == Maze_encoding::passages ? cells * Passage_maze::passage_bits_ : header.rows * header.cols;
+  if ( header.raw_bytes * 8 < needed_bits || header.raw_bytes % sizeof( uint64_t ) ) {
+    abort_maze_file( path, "payload is too small for its dimensions" );
+  }
+
+  args.odd_rows = header.rows;
+  args.odd_cols = header.cols;
+  Maze maze( args );
+  if ( static_cast<uint64_t>( maze.row_size() ) != header.rows
+       || static_cast<uint64_t>( maze.col_size() ) != header.cols ) {
+    abort_maze_file( path, "does not fit the dimensions of the maze it is loaded into" );
+  }
+  const std::span<const uint8_t> payload = bytes.subspan( sizeof( header ) );
+  if ( header.compressed ) {
+    const std::vector<uint64_t> words = decompress( path, payload, header.raw_bytes );
+    expand_payload( words, header, maze );
+  } else {
+    // The header keeps the payload word aligned within the page aligned mapping.
+    const std::span<const uint64_t> words( reinterpret_cast<const uint64_t*>( payload.data() ),
+                                           payload.size() / sizeof( uint64_t ) );
+    expand_payload( words, header, maze );
+  }
+  maze.mark_built();
+  return maze;
+}
+
+} // namespace Builder
@@ -0,0 +1,60 @@
+#pragma once
+#ifndef MAZE_FILE_HH
+#define MAZE_FILE_HH
+#include "maze.hh"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Builder {
+
+/* A built maze on disk. The header records how the maze was made and the payload is one of two bit
+ * packed encodings. Perfect mazes only need the east and south passage of every cell so they are
+ * stored exactly like a Passage_maze, two bits per cell. Anything else, such as an arena or a maze
+ * with a modification, stores the path bit of every square. Wall glyphs are never stored because
+ * every wall connects to the walls around it and they are recomputed on load.
+ *
+ * header--------------fixed size, see Maze_file_header.
+ * payload-------------packed 64 bit words or a run length encoding of their bytes.
+ *
+ * A payload is only written compressed if that makes it smaller. An uncompressed payload is read
+ * straight from the mapped file with no intermediate copy.
+ */
+enum class Maze_encoding : uint32_t
+{
+  passages = 0,
+  squares,
+};
+
+struct Maze_file_header
+{
+  std::array<char, 8> magic;
+  uint32_t version;
+  Maze_encoding encoding;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t seed;
+  std::array<char, 32> builder;
+  uint64_t compressed;
+  uint64_t payload_bytes;
+  uint64_t raw_bytes;
+};
+
+struct Maze_file_info
+{
+  std::string builder;
+  uint64_t seed;
+};
+
+void save_maze( const Maze& maze, const std::string& path, const Maze_file_info& info );
+
+/* Reads the dimensions from the header so the maze is constructed at the saved size. The style and
+ * storage settings of args are kept.
+ */
+Maze load_maze( const std::string& path, Maze::Maze_args args );
+
+} // namespace Builder
+
+#endif
@@ -0,0 +1,61 @@
+#include "maze_random.hh"
+
+#include <atomic>
+#include <random>
+
+namespace {
+
+uint64_t seed_from_device()
+{
+  std::random_device device;
+  return ( uint64_t { device() } << 32 ) | device();
+}
+
+std::atomic<uint64_t> process_seed { seed_from_device() };
+std::atomic<uint64_t> process_stream { 0 };
+
+struct Thread_streams
+{
+  bool active;
+  uint64_t seed;
+  uint64_t next_stream;
+};
+
+thread_local Thread_streams thread_streams { false, 0, 0 };
+
+} // namespace
+
+void seed_maze_random( uint64_t seed )
+{
+  process_seed.store( seed );
+  process_stream.store( 0 );
+}
+
+uint64_t maze_random_seed()
+{
+  return process_seed.load();
+}
+
+Maze_random make_maze_random()
+{
+  if ( thread_streams.active ) {
+    return make_maze_random( thread_streams.seed, thread_streams.next_stream++ );
+  }
+  return make_maze_random( process_seed.load(), process_stream.fetch_add( 1 ) );
+}
+
+Maze_random make_maze_random( uint64_t seed, uint64_t stream )
+{
+  return Maze_random( seed ^ Xoshiro256::mix( stream + 1 ) );
+}
+
+Random_streams::Random_streams( uint64_t seed )
+  : had_streams_( thread_streams.active ), seed_( thread_streams.seed ), next_stream_( thread_streams.next_stream )
+{
+  thread_streams = { true, seed, 0 };
+}
+
+Random_streams::~Random_streams()
+{
+  thread_streams = { had_streams_, seed_, next_stream_ };
+}
@@ -0,0 +1,183 @@
+#pragma once
+#ifndef MAZE_RANDOM_HH
+#define MAZE_RANDOM_HH
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+/* xoshiro256** by Blackman and Vigna. Four words of state, a few shifts and one multiply per draw
+ * and it passes every statistical test a maze could care about. It meets the standard uniform random
+ * bit generator requirements so the standard distributions and algorithms accept it.
+ */
+class Xoshiro256
+{
+public:
+  using result_type = uint64_t;
+
+  // Seeds are spread over the state with splitmix64 so nearby seeds give unrelated streams.
+  explicit Xoshiro256( uint64_t seed )
+  {
+    for ( uint64_t& word : state_ ) {
+      seed += 0x9e3779b97f4a7c15ULL;
+      word = mix( seed );
+    }
+  }
+
+  static constexpr result_type min()
+  {
+    return 0;
+  }
+
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()()
+  {
+    const uint64_t result = rotate_left( state_[1] * 5, 7 ) * 9;
+    const uint64_t shifted = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= shifted;
+    state_[3] = rotate_left( state_[3], 45 );
+    return result;
+  }
+
+  // The splitmix64 finalizer. It is a bijection so distinct inputs never collide.
+  static uint64_t mix( uint64_t x )
+  {
+    x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+    return x ^ ( x >> 31 );
+  }
+
+private:
+  std::array<uint64_t, 4> state_ {};
+
+  static uint64_t rotate_left( uint64_t x, int k )
+  {
+    return ( x << k ) | ( x >> ( 64 - k ) );
+  }
+};
+
+/* The random source every builder and solver draws from. Most draws in a maze pick one of a handful
+ * of directions, which needs two or three bits, so small draws are cut from a buffered word instead
+ * of spending a whole call to the engine on each. Any engine with the standard generator interface
+ * that returns 64 bit words fits and Maze_random below names the one in use.
+ */
+template<typename Engine>
+class Random_source
+{
+public:
+  using result_type = uint64_t;
+
+  explicit Random_source( uint64_t seed ) : engine_( seed ) {}
+
+  static constexpr result_type min()
+  {
+    return 0;
+  }
+
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()()
+  {
+    return engine_();
+  }
+
+  // The next count bits of the buffer, refilled from the engine as it runs out. Count is at most 64.
+  uint64_t bits( unsigned count )
+  {
+    if ( count == 0 ) {
+      return 0;
+    }
+    if ( count > buffered_ ) {
+      buffer_ = engine_();
+      buffered_ = 64;
+    }
+    const uint64_t result = count == 64 ? buffer_ : buffer_ & ( ( uint64_t { 1 } << count ) - 1 );
+    buffer_ = count == 64 ? 0 : buffer_ >> count;
+    buffered_ -= count;
+    return result;
+  }
+
+  // A uniform number in [0, bound) from as few buffered bits as cover the bound, redrawn when too large.
+  uint64_t below( uint64_t bound )
+  {
+    if ( bound <= 1 ) {
+      return 0;
+    }
+    const unsigned width = 64U - static_cast<unsigned>( std::countl_zero( bound - 1 ) );
+    for ( ;; ) {
+      const uint64_t draw = bits( width );
+      if ( draw < bound ) {
+        return draw;
+      }
+    }
+  }
+
+  // A uniform number in [low, high].
+  int64_t between( int64_t low, int64_t high )
+  {
+    return low + static_cast<int64_t>( below( static_cast<uint64_t>( high - low ) + 1 ) );
+  }
+
+  // Fisher-Yates. Four directions cost under six bits on average so one word covers about ten shuffles.
+  template<typename Range>
+  void shuffle( Range& range )
+  {
+    for ( uint64_t i = range.size(); i > 1; i-- ) {
+      using std::swap;
+      swap( range[i - 1], range[below( i )] );
+    }
+  }
+
+private:
+  Engine engine_;
+  uint64_t buffer_ { 0 };
+  unsigned buffered_ { 0 };
+};
+
+using Maze_random = Random_source<Xoshiro256>;
+
+/* Every generator comes from one process seed and a stream number so a seed given on the command
+ * line replays the same maze. Streams are numbered in the order they are asked for, which is fixed
+ * for everything that runs on one thread. Without a seed the process seed is drawn once at start.
+ */
+void seed_maze_random( uint64_t seed );
+// The process seed, drawn or given, so a run without a seed may still be replayed.
+uint64_t maze_random_seed();
+Maze_random make_maze_random();
+// Stream number stream of seed. Threads that must not race for stream numbers each take their own.
+Maze_random make_maze_random( uint64_t seed, uint64_t stream );
+
+/* A thread holding one of these numbers its streams from the given seed instead of from the process
+ * seed. A builder run on its own thread, like one tile of a tiled build, then draws the same numbers
+ * no matter how the threads around it are scheduled.
+ */
+class Random_streams
+{
+public:
+  explicit Random_streams( uint64_t seed );
+  ~Random_streams();
+  Random_streams( const Random_streams& ) = delete;
+  Random_streams& operator=( const Random_streams& ) = delete;
+  Random_streams( Random_streams&& ) = delete;
+  Random_streams& operator=( Random_streams&& ) = delete;
+
+private:
+  bool had_streams_;
+  uint64_t seed_;
+  uint64_t next_stream_;
+};
+
+#endif
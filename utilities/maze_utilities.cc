@@ -1,20 +1,201 @@
 #include "maze_utilities.hh"
+#include "maze_random.hh"
 #include "print_utilities.hh"
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 namespace Builder {
 
+namespace {
+
+thread_local bool silent_flush = false;
+
+/* The helpers that accept a Maze_view share one body with their Maze versions. Both index the same
+ * way so the full maze pays nothing for the view support.
+ */
+template<typename Grid>
+void build_path_in( Grid& maze, const Maze::Point& p )
+{
+  if ( p.row - 1 >= 0 ) {
+    maze[p.row - 1][p.col] &= static_cast<Maze::Square>( ~Maze::south_wall_ );
+  }
+  if ( p.row + 1 < maze.row_size() ) {
+    maze[p.row + 1][p.col] &= static_cast<Maze::Square>( ~Maze::north_wall_ );
+  }
+  if ( p.col - 1 >= 0 ) {
+    maze[p.row][p.col - 1] &= static_cast<Maze::Square>( ~Maze::east_wall_ );
+  }
+  if ( p.col + 1 < maze.col_size() ) {
+    maze[p.row][p.col + 1] &= static_cast<Maze::Square>( ~Maze::west_wall_ );
+  }
+  maze[p.row][p.col] |= Maze::path_bit_;
+}
+
+template<typename Grid>
+void build_wall_line_in( Grid& maze, const Maze::Point& p )
+{
+  Maze::Wall_line wall = 0b0;
+  if ( p.row - 1 >= 0 && !( maze[p.row - 1][p.col] & Maze::path_bit_ ) ) {
+    wall |= Maze::north_wall_;
+    maze[p.row - 1][p.col] |= Maze::south_wall_;
+  }
+  if ( p.row + 1 < maze.row_size() && !( maze[p.row + 1][p.col] & Maze::path_bit_ ) ) {
+    wall |= Maze::south_wall_;
+    maze[p.row + 1][p.col] |= Maze::north_wall_;
+  }
+  if ( p.col - 1 >= 0 && !( maze[p.row][p.col - 1] & Maze::path_bit_ ) ) {
+    wall |= Maze::west_wall_;
+    maze[p.row][p.col - 1] |= Maze::east_wall_;
+  }
+  if ( p.col + 1 < maze.col_size() && !( maze[p.row][p.col + 1] & Maze::path_bit_ ) ) {
+    wall |= Maze::east_wall_;
+    maze[p.row][p.col + 1] |= Maze::west_wall_;
+  }
+  maze[p.row][p.col] |= wall;
+  maze[p.row][p.col] |= Maze::builder_bit_;
+  maze[p.row][p.col] &= static_cast<Maze::Square>( ~Maze::path_bit_ );
+}
+
+template<typename Grid>
+void carve_path_walls_in( Grid& maze, const Maze::Point& p )
+{
+  maze[p.row][p.col] |= Maze::path_bit_;
+  if ( p.row - 1 >= 0 ) {
+    maze[p.row - 1][p.col] &= static_cast<Maze::Square>( ~Maze::south_wall_ );
+  }
+  if ( p.row + 1 < maze.row_size() ) {
+    maze[p.row + 1][p.col] &= static_cast<Maze::Square>( ~Maze::north_wall_ );
+  }
+  if ( p.col - 1 >= 0 ) {
+    maze[p.row][p.col - 1] &= static_cast<Maze::Square>( ~Maze::east_wall_ );
+  }
+  if ( p.col + 1 < maze.col_size() ) {
+    maze[p.row][p.col + 1] &= static_cast<Maze::Square>( ~Maze::west_wall_ );
+  }
+  maze[p.row][p.col] |= Maze::builder_bit_;
+}
+
+template<typename Grid>
+void join_squares_in( Grid& maze, const Maze::Point& cur, const Maze::Point& next )
+{
+  Maze::Point wall = cur;
+  build_path_in( maze, cur );
+  maze[cur.row][cur.col] |= Maze::builder_bit_;
+  if ( next.row < cur.row ) {
+    wall.row--;
+  } else if ( next.row > cur.row ) {
+    wall.row++;
+  } else if ( next.col < cur.col ) {
+    wall.col--;
+  } else if ( next.col > cur.col ) {
+    wall.col++;
+  } else {
+    std::cerr << "Wall break error. Step through wall didn't work" << std::endl;
+  }
+  build_path_in( maze, wall );
+  maze[wall.row][wall.col] |= Maze::builder_bit_;
+  build_path_in( maze, next );
+  maze[next.row][next.col] |= Maze::builder_bit_;
+}
+
+template<typename Grid>
+void print_square_in( const Grid& maze, const Maze::Point& p )
+{
+  const Maze::Square square = maze[p.row][p.col];
+  if ( square & Maze::markers_mask_ ) {
+    const Maze::Backtrack_marker mark
+      = static_cast<Maze::Backtrack_marker>( square & Maze::markers_mask_ ) >> Maze::marker_shift_;
+    std::cout << Maze::backtracking_symbols_.at( mark );
+  } else if ( !( square & Maze::path_bit_ ) ) {
+    std::cout << maze.wall_style().at( square & Maze::wall_mask_ );
+  } else if ( square & Maze::path_bit_ ) {
+    std::cout << " ";
+  } else {
+    std::cerr << "Printed maze and a square was not categorized." << std::endl;
+    abort();
+  }
+}
+
+bool is_dead_end( const Maze& maze, const Maze::Point& cell )
+{
+  if ( !( maze[cell.row][cell.col] & Maze::path_bit_ ) ) {
+    return false;
+  }
+  int open = 0;
+  for ( const Maze::Point& d : Maze::cardinal_directions_ ) {
+    if ( maze[cell.row + d.row][cell.col + d.col] & Maze::path_bit_ ) {
+      open++;
+    }
+  }
+  return open == 1;
+}
+
+/* Decides every wall a braid opens before any is opened so every band of cell rows reads the maze
+ * as the builder left it. Whether a dead end is removed is a hash of the seed and the cell, so any
+ * band can tell whether a neighbor in another band will be removed too. A removed dead end opens a
+ * wall toward a removed neighbor first, which clears two dead ends with at most two walls, then
+ * toward any cell that is not a dead end, and only then toward a dead end that is kept, so about
+ * fraction of the dead ends go. Each cell row draws its wall choices from its own stream.
+ */
+std::vector<std::vector<Maze::Point>> choose_braid_walls( const Maze& maze, double fraction )
+{
+  const auto cell_rows = static_cast<uint64_t>( ( maze.row_size() - 1 ) / 2 );
+  const auto cell_cols = static_cast<uint64_t>( ( maze.col_size() - 1 ) / 2 );
+  const auto threshold = static_cast<uint64_t>( fraction * static_cast<double>( uint64_t { 1 } << 32 ) );
+  const uint64_t seed = make_maze_random()();
+  const auto removed = [&maze, cell_cols, threshold, seed]( const Maze::Point& cell ) {
+    const auto id = ( static_cast<uint64_t>( cell.row / 2 ) * cell_cols ) + static_cast<uint64_t>( cell.col / 2 );
+    return is_dead_end( maze, cell ) && ( Xoshiro256::mix( seed ^ id ) >> 32 ) < threshold;
+  };
+  std::vector<std::vector<Maze::Point>> walls( cell_rows );
+  for_each_slice( cell_rows, [&maze, &walls, &removed, cell_cols, seed]( uint64_t first, uint64_t last ) {
+    for ( uint64_t cell_row = first; cell_row < last; cell_row++ ) {
+      Maze_random gen = make_maze_random( seed, cell_row );
+      const auto row = static_cast<int64_t>( ( 2 * cell_row ) + 1 );
+      for ( int64_t col = 1; col < static_cast<int64_t>( 2 * cell_cols ); col += 2 ) {
+        if ( !removed( { row, col } ) ) {
+          continue;
+        }
+        // Closed walls by preference: toward removed dead ends, other cells, then kept dead ends.
+        std::array<std::array<Maze::Point, 4>, 3> choices {};
+        std::array<uint64_t, 3> counts {};
+        for ( const Maze::Point& d : Maze::cardinal_directions_ ) {
+          const Maze::Point wall = { row + d.row, col + d.col };
+          const Maze::Point next = { row + ( 2 * d.row ), col + ( 2 * d.col ) };
+          if ( ( maze[wall.row][wall.col] & Maze::path_bit_ ) || !is_square_within_perimeter_walls( maze, next )
+               || !( maze[next.row][next.col] & Maze::path_bit_ ) ) {
+            continue;
+          }
+          const uint64_t tier = removed( next ) ? 0 : is_dead_end( maze, next ) ? 2 : 1;
+          choices.at( tier ).at( counts.at( tier )++ ) = wall;
+        }
+        for ( uint64_t tier = 0; tier < counts.size(); tier++ ) {
+          if ( counts.at( tier ) ) {
+            walls[cell_row].push_back( choices.at( tier ).at( gen.below( counts.at( tier ) ) ) );
+            break;
+          }
+        }
+      }
+    }
+  } );
+  return walls;
+}
+
+} // namespace
+
 void add_positive_slope( Maze& maze, const Maze::Point& p )
 {
-  const auto row_size = static_cast<float>( maze.row_size() ) - 2.0F;
-  const auto col_size = static_cast<float>( maze.col_size() ) - 2.0F;
-  const auto cur_row = static_cast<float>( p.row );
+  const auto row_size = static_cast<double>( maze.row_size() ) - 2.0;
+  const auto col_size = static_cast<double>( maze.col_size() ) - 2.0;
+  const auto cur_row = static_cast<double>( p.row );
   // y = mx + b. We will get the negative slope. This line goes top left to bottom right.
-  const float slope = ( 2.0F - row_size ) / ( 2.0F - col_size );
-  const float b = 2.0F - ( 2.0F * slope );
-  const int on_line = static_cast<int>( ( cur_row - b ) / slope );
+  const double slope = ( 2.0 - row_size ) / ( 2.0 - col_size );
+  const double b = 2.0 - ( 2.0 * slope );
+  const auto on_line = static_cast<int64_t>( ( cur_row - b ) / slope );
   if ( p.col == on_line && p.col < maze.col_size() - 2 && p.col > 1 ) {
     // An X is hard to notice and might miss breaking wall lines so make it wider.
     build_path( maze, p );
@@ -35,13 +216,13 @@ void add_positive_slope( Maze& maze, const Maze::Point& p )
 
 void add_positive_slope_animated( Maze& maze, const Maze::Point& p, Speed_unit speed )
 {
-  const auto row_size = static_cast<float>( maze.row_size() ) - 2.0F;
-  const auto col_size = static_cast<float>( maze.col_size() ) - 2.0F;
-  const auto cur_row = static_cast<float>( p.row );
+  const auto row_size = static_cast<double>( maze.row_size() ) - 2.0;
+  const auto col_size = static_cast<double>( maze.col_size() ) - 2.0;
+  const auto cur_row = static_cast<double>( p.row );
   // y = mx + b. We will get the negative slope. This line goes top left to bottom right.
-  const float slope = ( 2.0F - row_size ) / ( 2.0F - col_size );
-  const float b = 2.0F - ( 2.0F * slope );
-  const int on_line = static_cast<int>( ( cur_row - b ) / slope );
+  const double slope = ( 2.0 - row_size ) / ( 2.0 - col_size );
+  const double b = 2.0 - ( 2.0 * slope );
+  const auto on_line = static_cast<int64_t>( ( cur_row - b ) / slope );
   if ( p.col == on_line && p.col < maze.col_size() - 2 && p.col > 1 ) {
     // An X is hard to notice and might miss breaking wall lines so make it wider.
     build_path_animated( maze, p, speed );
@@ -62,12 +243,12 @@ void add_positive_slope_animated( Maze& maze, const Maze::Point& p, Speed_unit s
 
 void add_negative_slope( Maze& maze, const Maze::Point& p )
 {
-  const auto row_size = static_cast<float>( maze.row_size() ) - 2.0F;
-  const auto col_size = static_cast<float>( maze.col_size() ) - 2.0F;
-  const auto cur_row = static_cast<float>( p.row );
-  const float slope = ( 2.0F - row_size ) / ( col_size - 2.0F );
-  const float b = row_size - ( 2.0F * slope );
-  const int on_line = static_cast<int>( ( cur_row - b ) / slope );
+  const auto row_size = static_cast<double>( maze.row_size() ) - 2.0;
+  const auto col_size = static_cast<double>( maze.col_size() ) - 2.0;
+  const auto cur_row = static_cast<double>( p.row );
+  const double slope = ( 2.0 - row_size ) / ( col_size - 2.0 );
+  const double b = row_size - ( 2.0 * slope );
+  const auto on_line = static_cast<int64_t>( ( cur_row - b ) / slope );
   if ( p.col == on_line && p.col > 1 && p.col < maze.col_size() - 2 && p.row < maze.row_size() - 2 ) {
     build_path( maze, p );
     if ( p.col + 1 < maze.col_size() - 2 ) {
@@ -87,12 +268,12 @@ void add_negative_slope( Maze& maze, const Maze::Point& p )
 
 void add_negative_slope_animated( Maze& maze, const Maze::Point& p, Speed_unit speed )
 {
-  const auto row_size = static_cast<float>( maze.row_size() ) - 2.0F;
-  const auto col_size = static_cast<float>( maze.col_size() ) - 2.0F;
-  const auto cur_row = static_cast<float>( p.row );
-  const float slope = ( 2.0F - row_size ) / ( col_size - 2.0F );
-  const float b = row_size - ( 2.0F * slope );
-  const int on_line = static_cast<int>( ( cur_row - b ) / slope );
+  const auto row_size = static_cast<double>( maze.row_size() ) - 2.0;
+  const auto col_size = static_cast<double>( maze.col_size() ) - 2.0;
+  const auto cur_row = static_cast<double>( p.row );
+  const double slope = ( 2.0 - row_size ) / ( col_size - 2.0 );
+  const double b = row_size - ( 2.0 * slope );
+  const auto on_line = static_cast<int64_t>( ( cur_row - b ) / slope );
   if ( p.col == on_line && p.col > 1 && p.col < maze.col_size() - 2 && p.row < maze.row_size() - 2 ) {
     build_path_animated( maze, p, speed );
     if ( p.col + 1 < maze.col_size() - 2 ) {
@@ -112,8 +293,8 @@ void add_negative_slope_animated( Maze& maze, const Maze::Point& p, Speed_unit s
 
 void add_cross( Maze& maze )
 {
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       if ( ( row == maze.row_size() / 2 && col > 1 && col < maze.col_size() - 2 )
            || ( col == maze.col_size() / 2 && row > 1 && row < maze.row_size() - 2 ) ) {
         build_path( maze, { row, col } );
@@ -128,8 +309,8 @@ void add_cross( Maze& maze )
 void add_cross_animated( Maze& maze, Builder_speed speed )
 {
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
-  for ( int row = 1; row < maze.row_size() - 1; row++ ) {
-    for ( int col = 1; col < maze.col_size() - 1; col++ ) {
+  for ( int64_t row = 1; row < maze.row_size() - 1; row++ ) {
+    for ( int64_t col = 1; col < maze.col_size() - 1; col++ ) {
       if ( ( row == maze.row_size() / 2 && col > 1 && col < maze.col_size() - 2 )
            || ( col == maze.col_size() / 2 && row > 1 && row < maze.row_size() - 2 ) ) {
         build_path_animated( maze, { row, col }, animation );
@@ -143,8 +324,8 @@ void add_cross_animated( Maze& maze, Builder_speed speed )
 
 void add_x( Maze& maze )
 {
-  for ( int row = 1; row < maze.row_size() - 1; row++ ) {
-    for ( int col = 1; col < maze.col_size() - 1; col++ ) {
+  for ( int64_t row = 1; row < maze.row_size() - 1; row++ ) {
+    for ( int64_t col = 1; col < maze.col_size() - 1; col++ ) {
       add_positive_slope( maze, { row, col } );
       add_negative_slope( maze, { row, col } );
     }
@@ -154,18 +335,50 @@ void add_x( Maze& maze )
 void add_x_animated( Maze& maze, Builder_speed speed )
 {
   const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
-  for ( int row = 1; row < maze.row_size() - 1; row++ ) {
-    for ( int col = 1; col < maze.col_size() - 1; col++ ) {
+  for ( int64_t row = 1; row < maze.row_size() - 1; row++ ) {
+    for ( int64_t col = 1; col < maze.col_size() - 1; col++ ) {
       add_positive_slope_animated( maze, { row, col }, animation );
       add_negative_slope_animated( maze, { row, col }, animation );
     }
   }
 }
 
+/* Two dead ends that face each other may pick the same wall from different bands, so walls are opened
+ * with an atomic or. The glyphs are redrawn from the path bits once every wall is open.
+ */
+void add_braids( Maze& maze, double fraction )
+{
+  const std::vector<std::vector<Maze::Point>> walls = choose_braid_walls( maze, fraction );
+  for_each_slice( walls.size(), [&maze, &walls]( uint64_t first, uint64_t last ) {
+    for ( uint64_t cell_row = first; cell_row < last; cell_row++ ) {
+      for ( const Maze::Point& wall : walls[cell_row] ) {
+        std::atomic_ref<Maze::Square>( maze[wall.row][wall.col] )
+          .fetch_or( Maze::path_bit_ | Maze::builder_bit_, std::memory_order_relaxed );
+      }
+    }
+  } );
+  for_each_slice( static_cast<uint64_t>( maze.row_size() ),
+                  [&maze]( uint64_t first, uint64_t last ) { rebuild_wall_lines( maze, first, last ); } );
+}
+
+void add_braids_animated( Maze& maze, double fraction, Builder_speed speed )
+{
+  const Speed_unit animation = builder_speeds_.at( static_cast<int>( speed ) );
+  for ( const std::vector<Maze::Point>& row : choose_braid_walls( maze, fraction ) ) {
+    for ( const Maze::Point& wall : row ) {
+      if ( !( maze[wall.row][wall.col] & Maze::path_bit_ ) ) {
+        build_path_animated( maze, wall, animation );
+        maze[wall.row][wall.col] |= Maze::builder_bit_;
+      }
+    }
+  }
+}
+
 void build_wall_outline( Maze& maze )
 {
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  maze.advise( Maze::Access_pattern::sequential );
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       if ( col == 0 || col == maze.col_size() - 1 || row == 0 || row == maze.row_size() - 1 ) {
         maze[row][col] |= Maze::builder_bit_;
         build_wall_carefully( maze, { row, col } );
@@ -174,13 +387,47 @@ void build_wall_outline( Maze& maze )
       }
     }
   }
+  maze.advise( Maze::Access_pattern::random );
+}
+
+void rebuild_wall_lines( Maze& maze, uint64_t first_row, uint64_t last_row )
+{
+  const int64_t rows = maze.row_size();
+  const int64_t cols = maze.col_size();
+  // Neighbor rows may belong to another thread so path bits are read as relaxed atomics.
+  const auto is_wall = [&maze, rows, cols]( int64_t row, int64_t col ) {
+    return row >= 0 && col >= 0 && row < rows && col < cols
+           && !( std::atomic_ref<Maze::Square>( maze[row][col] ).load( std::memory_order_relaxed )
+                 & Maze::path_bit_ );
+  };
+  for ( auto row = static_cast<int64_t>( first_row ); row < static_cast<int64_t>( last_row ); row++ ) {
+    for ( int64_t col = 0; col < cols; col++ ) {
+      if ( !is_wall( row, col ) ) {
+        continue;
+      }
+      Maze::Wall_line wall = 0b0;
+      if ( is_wall( row - 1, col ) ) {
+        wall |= Maze::north_wall_;
+      }
+      if ( is_wall( row, col + 1 ) ) {
+        wall |= Maze::east_wall_;
+      }
+      if ( is_wall( row + 1, col ) ) {
+        wall |= Maze::south_wall_;
+      }
+      if ( is_wall( row, col - 1 ) ) {
+        wall |= Maze::west_wall_;
+      }
+      std::atomic_ref<Maze::Square>( maze[row][col] ).store( wall, std::memory_order_relaxed );
+    }
+  }
 }
 
 Maze::Point choose_arbitrary_point( const Maze& maze, Parity_point parity )
 {
-  const int init = parity == Parity_point::even ? 2 : 1;
-  for ( int row = init; row < maze.row_size() - 1; row += 2 ) {
-    for ( int col = init; col < maze.col_size() - 1; col += 2 ) {
+  const int64_t init = parity == Parity_point::even ? 2 : 1;
+  for ( int64_t row = init; row < maze.row_size() - 1; row += 2 ) {
+    for ( int64_t col = init; col < maze.col_size() - 1; col += 2 ) {
       if ( !( maze[row][col] & Maze::builder_bit_ ) ) {
         return { row, col };
       }
@@ -189,6 +436,23 @@ Maze::Point choose_arbitrary_point( const Maze& maze, Parity_point parity )
   return { 0, 0 };
 }
 
+Unvisited_scan::Unvisited_scan( Parity_point parity )
+  : cur_( parity == Parity_point::even ? Maze::Point { 2, 2 } : Maze::Point { 1, 1 } )
+{}
+
+Maze::Point Unvisited_scan::next( const Maze& maze )
+{
+  const int64_t init = cur_.row % 2 ? 1 : 2;
+  for ( ; cur_.row < maze.row_size() - 1; cur_.row += 2, cur_.col = init ) {
+    for ( ; cur_.col < maze.col_size() - 1; cur_.col += 2 ) {
+      if ( !( maze[cur_.row][cur_.col] & Maze::builder_bit_ ) ) {
+        return cur_;
+      }
+    }
+  }
+  return { 0, 0 };
+}
+
 bool can_build_new_square( const Maze& maze, const Maze::Point& next )
 {
   return next.row > 0 && next.row < maze.row_size() - 1 && next.col > 0 && next.col < maze.col_size() - 1
@@ -207,26 +471,12 @@ bool is_square_within_perimeter_walls( const Maze& maze, const Maze::Point& next
 
 void build_wall_line( Maze& maze, const Maze::Point& p )
 {
-  Maze::Wall_line wall = 0b0;
-  if ( p.row - 1 >= 0 && !( maze[p.row - 1][p.col] & Maze::path_bit_ ) ) {
-    wall |= Maze::north_wall_;
-    maze[p.row - 1][p.col] |= Maze::south_wall_;
-  }
-  if ( p.row + 1 < maze.row_size() && !( maze[p.row + 1][p.col] & Maze::path_bit_ ) ) {
-    wall |= Maze::south_wall_;
-    maze[p.row + 1][p.col] |= Maze::north_wall_;
-  }
-  if ( p.col - 1 >= 0 && !( maze[p.row][p.col - 1] & Maze::path_bit_ ) ) {
-    wall |= Maze::west_wall_;
-    maze[p.row][p.col - 1] |= Maze::east_wall_;
-  }
-  if ( p.col + 1 < maze.col_size() && !( maze[p.row][p.col + 1] & Maze::path_bit_ ) ) {
-    wall |= Maze::east_wall_;
-    maze[p.row][p.col + 1] |= Maze::west_wall_;
-  }
-  maze[p.row][p.col] |= wall;
-  maze[p.row][p.col] |= Maze::builder_bit_;
-  maze[p.row][p.col] &= static_cast<Maze::Square>( ~Maze::path_bit_ );
+  build_wall_line_in( maze, p );
+}
+
+void build_wall_line( const Maze_view& maze, const Maze::Point& p )
+{
+  build_wall_line_in( maze, p );
 }
 
 void build_wall_line_animated( Maze& maze, const Maze::Point& p, Speed_unit speed )
@@ -265,8 +515,8 @@ void build_wall_line_animated( Maze& maze, const Maze::Point& p, Speed_unit spee
 
 void clear_for_wall_adders( Maze& maze )
 {
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       if ( col == 0 || col == maze.col_size() - 1 || row == 0 || row == maze.row_size() - 1 ) {
         maze[row][col] |= Maze::builder_bit_;
       } else {
@@ -308,18 +558,21 @@ void mark_origin_animated( Maze& maze, const Maze::Point& walk, const Maze::Poin
 
 void fill_maze_with_walls( Maze& maze )
 {
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  // The fill streams through every square once and then the carvers jump around the grid.
+  maze.advise( Maze::Access_pattern::sequential );
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       build_wall( maze, { row, col } );
     }
   }
+  maze.advise( Maze::Access_pattern::random );
 }
 
 void fill_maze_with_walls_animated( Maze& maze )
 {
   Printer::clear_screen();
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       build_wall( maze, { row, col } );
     }
   }
@@ -327,20 +580,12 @@ void fill_maze_with_walls_animated( Maze& maze )
 
 void carve_path_walls( Maze& maze, const Maze::Point& p )
 {
-  maze[p.row][p.col] |= Maze::path_bit_;
-  if ( p.row - 1 >= 0 ) {
-    maze[p.row - 1][p.col] &= static_cast<Maze::Square>( ~Maze::south_wall_ );
-  }
-  if ( p.row + 1 < maze.row_size() ) {
-    maze[p.row + 1][p.col] &= static_cast<Maze::Square>( ~Maze::north_wall_ );
-  }
-  if ( p.col - 1 >= 0 ) {
-    maze[p.row][p.col - 1] &= static_cast<Maze::Square>( ~Maze::east_wall_ );
-  }
-  if ( p.col + 1 < maze.col_size() ) {
-    maze[p.row][p.col + 1] &= static_cast<Maze::Square>( ~Maze::west_wall_ );
-  }
-  maze[p.row][p.col] |= Maze::builder_bit_;
+  carve_path_walls_in( maze, p );
+}
+
+void carve_path_walls( const Maze_view& maze, const Maze::Point& p )
+{
+  carve_path_walls_in( maze, p );
 }
 
 // The animated version tries to save cursor movements if they are not necessary.
@@ -420,24 +665,12 @@ void carve_path_markings_animated( Maze& maze, const Maze::Point& cur, const Maz
 
 void join_squares( Maze& maze, const Maze::Point& cur, const Maze::Point& next )
 {
-  Maze::Point wall = cur;
-  build_path( maze, cur );
-  maze[cur.row][cur.col] |= Maze::builder_bit_;
-  if ( next.row < cur.row ) {
-    wall.row--;
-  } else if ( next.row > cur.row ) {
-    wall.row++;
-  } else if ( next.col < cur.col ) {
-    wall.col--;
-  } else if ( next.col > cur.col ) {
-    wall.col++;
-  } else {
-    std::cerr << "Wall break error. Step through wall didn't work" << std::endl;
-  }
-  build_path( maze, wall );
-  maze[wall.row][wall.col] |= Maze::builder_bit_;
-  build_path( maze, next );
-  maze[next.row][next.col] |= Maze::builder_bit_;
+  join_squares_in( maze, cur, next );
+}
+
+void join_squares( const Maze_view& maze, const Maze::Point& cur, const Maze::Point& next )
+{
+  join_squares_in( maze, cur, next );
 }
 
 void join_squares_animated( Maze& maze, const Maze::Point& cur, const Maze::Point& next, Speed_unit speed )
@@ -503,19 +736,7 @@ void build_wall_carefully( Maze& maze, const Maze::Point& p )
 
 void build_path( Maze& maze, const Maze::Point& p )
 {
-  if ( p.row - 1 >= 0 ) {
-    maze[p.row - 1][p.col] &= static_cast<Maze::Square>( ~Maze::south_wall_ );
-  }
-  if ( p.row + 1 < maze.row_size() ) {
-    maze[p.row + 1][p.col] &= static_cast<Maze::Square>( ~Maze::north_wall_ );
-  }
-  if ( p.col - 1 >= 0 ) {
-    maze[p.row][p.col - 1] &= static_cast<Maze::Square>( ~Maze::east_wall_ );
-  }
-  if ( p.col + 1 < maze.col_size() ) {
-    maze[p.row][p.col + 1] &= static_cast<Maze::Square>( ~Maze::west_wall_ );
-  }
-  maze[p.row][p.col] |= Maze::path_bit_;
+  build_path_in( maze, p );
 }
 
 void build_path_animated( Maze& maze, const Maze::Point& p, Speed_unit speed )
@@ -547,11 +768,25 @@ void build_path_animated( Maze& maze, const Maze::Point& p, Speed_unit speed )
 
 /* * * * * * * * * * * * * * *      Cout Printing Functions      * * * * * * * * * * * * * * * * */
 
+Silent_flush::Silent_flush() : was_silent_( silent_flush )
+{
+  silent_flush = true;
+}
+
+Silent_flush::~Silent_flush()
+{
+  silent_flush = was_silent_;
+}
+
 void clear_and_flush_grid( const Maze& maze )
 {
+  if ( silent_flush ) {
+    return;
+  }
+  maze.advise( Maze::Access_pattern::sequential );
   Printer::clear_screen();
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       print_square( maze, { row, col } );
     }
     std::cout << "\n";
@@ -581,25 +816,18 @@ void print_maze_square( const Maze& maze, const Maze::Point& p )
 
 void print_square( const Maze& maze, const Maze::Point& p )
 {
-  const Maze::Square& square = maze[p.row][p.col];
-  if ( square & Maze::markers_mask_ ) {
-    const Maze::Backtrack_marker mark
-      = static_cast<Maze::Backtrack_marker>( square & Maze::markers_mask_ ) >> Maze::marker_shift_;
-    std::cout << Maze::backtracking_symbols_.at( mark );
-  } else if ( !( square & Maze::path_bit_ ) ) {
-    std::cout << maze.wall_style().at( square & Maze::wall_mask_ );
-  } else if ( square & Maze::path_bit_ ) {
-    std::cout << " ";
-  } else {
-    std::cerr << "Printed maze and a square was not categorized." << std::endl;
-    abort();
-  }
+  print_square_in( maze, p );
+}
+
+void print_square( const Const_maze_view& maze, const Maze::Point& p )
+{
+  print_square_in( maze, p );
 }
 
 void print_maze( const Maze& maze )
 {
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
       print_square( maze, { row, col } );
     }
     std::cout << "\n";
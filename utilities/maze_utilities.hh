@@ -3,8 +3,13 @@
 #define MAZE_UTILITIES_HH
 
 #include "maze.hh"
+#include "maze_view.hh"
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 namespace Builder {
 
@@ -30,24 +35,83 @@ enum class Parity_point
 
 constexpr std::array<Speed_unit, 8> builder_speeds_ = { 0, 5000, 2500, 1000, 500, 250, 100, 1 };
 
+/* Runs work( first, last ) over even slices of [0, count) on num_threads threads and waits for them
+ * all. Every core is used unless told otherwise.
+ */
+template<typename Work>
+void for_each_slice( uint64_t count,
+                     const Work& work,
+                     uint64_t num_threads = std::max( 1U, std::thread::hardware_concurrency() ) )
+{
+  const uint64_t slice = std::max( uint64_t { 1 }, ( count + num_threads - 1 ) / num_threads );
+  std::vector<std::thread> threads;
+  threads.reserve( num_threads );
+  for ( uint64_t first = 0; first < count; first += slice ) {
+    threads.emplace_back( work, first, std::min( count, first + slice ) );
+  }
+  for ( std::thread& t : threads ) {
+    t.join();
+  }
+}
+
+/* Builders flush the finished maze to the screen. A builder run on a scratch maze, such as one tile
+ * of a tiled build, holds one of these so nothing is printed from its thread while it lives.
+ */
+class Silent_flush
+{
+public:
+  Silent_flush();
+  ~Silent_flush();
+  Silent_flush( const Silent_flush& ) = delete;
+  Silent_flush& operator=( const Silent_flush& ) = delete;
+  Silent_flush( Silent_flush&& ) = delete;
+  Silent_flush& operator=( Silent_flush&& ) = delete;
+
+private:
+  bool was_silent_;
+};
+
+/* Squares only ever gain the builder bit while a maze is built so the first square of a parity
+ * without it can only move forward. The scan resumes where it last stopped, which makes finding the
+ * next one O(1) amortized where choose_arbitrary_point starts over from the top every time.
+ */
+class Unvisited_scan
+{
+public:
+  explicit Unvisited_scan( Parity_point parity );
+  // The first square of the parity without the builder bit, or { 0, 0 } once every square has it.
+  Maze::Point next( const Maze& maze );
+
+private:
+  Maze::Point cur_;
+};
+
 void add_positive_slope( Maze& maze, const Maze::Point& p );
 void add_positive_slope_animated( Maze& maze, const Maze::Point& p, Speed_unit speed );
 void add_negative_slope( Maze& maze, const Maze::Point& p );
 void add_negative_slope_animated( Maze& maze, const Maze::Point& p, Speed_unit speed );
 void build_wall_line( Maze& maze, const Maze::Point& p );
+void build_wall_line( const Maze_view& maze, const Maze::Point& p );
 void build_wall_line_animated( Maze& maze, const Maze::Point& p, Speed_unit speed );
 void carve_path_walls( Maze& maze, const Maze::Point& p );
+void carve_path_walls( const Maze_view& maze, const Maze::Point& p );
 void carve_path_walls_animated( Maze& maze, const Maze::Point& p, Speed_unit speed );
 void carve_path_markings( Maze& maze, const Maze::Point& cur, const Maze::Point& next );
 void carve_path_markings_animated( Maze& maze, const Maze::Point& cur, const Maze::Point& next, Speed_unit speed );
 void build_wall_outline( Maze& maze );
+// Redraws the wall glyphs of rows [first_row, last_row) from path bits. Neighboring rows may be redrawn at once.
+void rebuild_wall_lines( Maze& maze, uint64_t first_row, uint64_t last_row );
 void fill_maze_with_walls( Maze& maze );
 void fill_maze_with_walls_animated( Maze& maze );
 void add_cross( Maze& maze );
 void add_cross_animated( Maze& maze, Builder_speed speed );
 void add_x( Maze& maze );
 void add_x_animated( Maze& maze, Builder_speed speed );
+// Opens one wall in about fraction of the dead ends, found by scanning bands of rows on every core.
+void add_braids( Maze& maze, double fraction );
+void add_braids_animated( Maze& maze, double fraction, Builder_speed speed );
 void join_squares( Maze& maze, const Maze::Point& cur, const Maze::Point& next );
+void join_squares( const Maze_view& maze, const Maze::Point& cur, const Maze::Point& next );
 void join_squares_animated( Maze& maze, const Maze::Point& cur, const Maze::Point& next, Speed_unit speed );
 void mark_origin( Maze& maze, const Maze::Point& walk, const Maze::Point& next );
 void mark_origin_animated( Maze& maze, const Maze::Point& walk, const Maze::Point& next, Speed_unit speed );
@@ -61,6 +125,7 @@ void clear_and_flush_grid( const Maze& maze );
 void clear_for_wall_adders( Maze& maze );
 void flush_cursor_maze_coordinate( const Maze& maze, const Maze::Point& p );
 void print_square( const Maze& maze, const Maze::Point& p );
+void print_square( const Const_maze_view& maze, const Maze::Point& p );
 void print_maze( const Maze& maze );
 void print_maze_square( const Maze& maze, const Maze::Point& p );
 bool can_build_new_square( const Maze& maze, const Maze::Point& next );
@@ -0,0 +1,122 @@
+#pragma once
+#ifndef MAZE_VIEW_HH
+#define MAZE_VIEW_HH
+#include "maze.hh"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace Builder {
+
+/* A rectangular window into a Maze that owns nothing. Square (0,0) of the view is the origin square
+ * of the maze and rows of the view are rows of the maze sliced from the origin column, so a view
+ * costs the same to index as the maze under either layout. Views of views stay relative to
+ * their parent. The maze must outlive every view of it.
+ *
+ * Builders and solvers may hand a view of a tile, a chamber, or the visible part of a huge maze to
+ * the helpers that accept one and they will never touch a square outside of it.
+ */
+template<typename Maze_type>
+class Basic_maze_view
+{
+public:
+  using Row = decltype( std::declval<Maze_type&>()[0] );
+
+  // The whole maze.
+  explicit Basic_maze_view( Maze_type& maze )
+    : maze_( &maze ), origin_ { 0, 0 }, rows_( maze.row_size() ), cols_( maze.col_size() )
+  {}
+
+  Basic_maze_view( Maze_type& maze, const Maze::Point& origin, int64_t rows, int64_t cols )
+    : maze_( &maze ), origin_( origin ), rows_( rows ), cols_( cols )
+  {
+    if ( origin.row < 0 || origin.col < 0 || rows < 0 || cols < 0 || origin.row + rows > maze.row_size()
+         || origin.col + cols > maze.col_size() ) {
+      throw std::out_of_range( "Maze view does not fit in its maze." );
+    }
+  }
+
+  Basic_maze_view( const Basic_maze_view& parent, const Maze::Point& origin, int64_t rows, int64_t cols )
+    : Basic_maze_view( *parent.maze_, parent.child_origin( origin, rows, cols ), rows, cols )
+  {}
+
+  // A view of a mutable maze may always be read as a view of a const one.
+  template<typename Mutable_maze>
+    requires( std::is_const_v<Maze_type> && !std::is_const_v<Mutable_maze> )
+  Basic_maze_view( const Basic_maze_view<Mutable_maze>& view )
+    : maze_( &view.maze() ), origin_( view.origin() ), rows_( view.row_size() ), cols_( view.col_size() )
+  {}
+
+  Row operator[]( uint64_t row ) const
+  {
+#ifdef MAZE_CHECKED_ACCESS
+    return at( row );
+#else
+    return ( *maze_ )[static_cast<uint64_t>( origin_.row ) + row].slice( static_cast<uint64_t>( origin_.col ),
+                                                                         static_cast<uint64_t>( cols_ ) );
+#endif
+  }
+
+  Row at( uint64_t row ) const
+  {
+    if ( row >= static_cast<uint64_t>( rows_ ) ) {
+      throw std::out_of_range( "Maze view row " + std::to_string( row ) + " is out of range." );
+    }
+    return maze_->at( static_cast<uint64_t>( origin_.row ) + row )
+      .slice( static_cast<uint64_t>( origin_.col ), static_cast<uint64_t>( cols_ ) );
+  }
+
+  int64_t row_size() const
+  {
+    return rows_;
+  }
+
+  int64_t col_size() const
+  {
+    return cols_;
+  }
+
+  // Where square (0,0) of the view sits in the maze.
+  const Maze::Point& origin() const
+  {
+    return origin_;
+  }
+
+  Maze_type& maze() const
+  {
+    return *maze_;
+  }
+
+  const std::array<std::string_view, 16>& wall_style() const
+  {
+    return maze_->wall_style();
+  }
+
+private:
+  // Checked against the parent before the maze check so a child may never reach outside its parent.
+  Maze::Point child_origin( const Maze::Point& origin, int64_t rows, int64_t cols ) const
+  {
+    if ( origin.row < 0 || origin.col < 0 || rows < 0 || cols < 0 || origin.row + rows > rows_
+         || origin.col + cols > cols_ ) {
+      throw std::out_of_range( "Maze view does not fit in its parent view." );
+    }
+    return { origin_.row + origin.row, origin_.col + origin.col };
+  }
+
+  Maze_type* maze_;
+  Maze::Point origin_;
+  int64_t rows_;
+  int64_t cols_;
+};
+
+using Maze_view = Basic_maze_view<Maze>;
+using Const_maze_view = Basic_maze_view<const Maze>;
+
+} // namespace Builder
+
+#endif
@@ -0,0 +1,119 @@
+#include "passage_maze.hh"
+
+#include <cstdint>
+#include <iostream>
+
+namespace Builder {
+
+namespace {
+
+bool is_open_square( const Passage_maze& passages, uint64_t row, uint64_t col )
+{
+  if ( row == 0 || col == 0 || row >= passages.row_size() - 1 || col >= passages.col_size() - 1 ) {
+    return false;
+  }
+  const bool odd_row = row % 2;
+  const bool odd_col = col % 2;
+  if ( odd_row && odd_col ) {
+    return true;
+  }
+  if ( odd_row ) {
+    return passages.is_east_open( { row / 2, ( col / 2 ) - 1 } );
+  }
+  if ( odd_col ) {
+    return passages.is_south_open( { ( row / 2 ) - 1, col / 2 } );
+  }
+  return false;
+}
+
+bool is_wall_square( const Passage_maze& passages, int64_t row, int64_t col )
+{
+  return row >= 0 && col >= 0 && static_cast<uint64_t>( row ) < passages.row_size()
+         && static_cast<uint64_t>( col ) < passages.col_size()
+         && !is_open_square( passages, static_cast<uint64_t>( row ), static_cast<uint64_t>( col ) );
+}
+
+} // namespace
+
+Passage_maze::Passage_maze( const Maze::Maze_args& args )
+  : cell_rows_( ( args.odd_rows - 1 ) / 2 )
+  , cell_cols_( ( args.odd_cols - 1 ) / 2 )
+  , passages_( ( ( cell_rows_ * cell_cols_ ) + cells_per_word_ - 1 ) / cells_per_word_, 0 )
+{}
+
+uint64_t Passage_maze::cell_rows() const
+{
+  return cell_rows_;
+}
+
+uint64_t Passage_maze::cell_cols() const
+{
+  return cell_cols_;
+}
+
+uint64_t Passage_maze::row_size() const
+{
+  return ( 2 * cell_rows_ ) + 1;
+}
+
+uint64_t Passage_maze::col_size() const
+{
+  return ( 2 * cell_cols_ ) + 1;
+}
+
+bool Passage_maze::has_passage( const Cell& c ) const
+{
+  return is_east_open( c ) || is_south_open( c ) || ( c.col > 0 && is_east_open( { c.row, c.col - 1 } ) )
+         || ( c.row > 0 && is_south_open( { c.row - 1, c.col } ) );
+}
+
+std::span<const Passage_maze::Passage_word> Passage_maze::words() const
+{
+  return passages_;
+}
+
+void Passage_maze::join_cells( const Cell& cur, const Cell& next )
+{
+  if ( next.row < cur.row ) {
+    open_south( next );
+  } else if ( next.row > cur.row ) {
+    open_south( cur );
+  } else if ( next.col < cur.col ) {
+    open_east( next );
+  } else if ( next.col > cur.col ) {
+    open_east( cur );
+  } else {
+    std::cerr << "Passage join error. Cells are not neighbors." << std::endl;
+    std::abort();
+  }
+}
+
+void expand_passage_region( const Passage_maze& passages, Maze& window, const Maze::Point& origin )
+{
+  for ( int64_t row = 0; row < window.row_size(); row++ ) {
+    for ( int64_t col = 0; col < window.col_size(); col++ ) {
+      const int64_t grid_row = static_cast<int64_t>( origin.row ) + row;
+      const int64_t grid_col = static_cast<int64_t>( origin.col ) + col;
+      if ( !is_wall_square( passages, grid_row, grid_col ) ) {
+        window[row][col] = Maze::path_bit_ | Maze::builder_bit_;
+        continue;
+      }
+      Maze::Wall_line wall = 0b0;
+      if ( is_wall_square( passages, grid_row - 1, grid_col ) ) {
+        wall |= Maze::north_wall_;
+      }
+      if ( is_wall_square( passages, grid_row, grid_col + 1 ) ) {
+        wall |= Maze::east_wall_;
+      }
+      if ( is_wall_square( passages, grid_row + 1, grid_col ) ) {
+        wall |= Maze::south_wall_;
+      }
+      if ( is_wall_square( passages, grid_row, grid_col - 1 ) ) {
+        wall |= Maze::west_wall_;
+      }
+      window[row][col] = static_cast<Maze::Square>( wall | Maze::builder_bit_ );
+    }
+  }
+}
+
+} // namespace Builder
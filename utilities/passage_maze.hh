@@ -0,0 +1,100 @@
+#pragma once
+#ifndef PASSAGE_MAZE_HH
+#define PASSAGE_MAZE_HH
+#include "maze.hh"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Builder {
+
+/* A perfect maze is fully described by which passages between cells are open. Every odd square of
+ * the Maze grid is a cell and every cell only needs to say if the passage to its east and to its
+ * south is open. The north and west passages belong to the neighbors. That is two bits per cell
+ * instead of the four sixteen bit squares per cell the full grid needs.
+ *
+ * cell word layout, 32 cells per word, cell 0 in the lowest bits.
+ *
+ * cell 1 south passage----||
+ * cell 1 east passage------|
+ * cell 0 south passage--|| |
+ * cell 0 east passage----| |
+ *                  0b... 1111
+ *
+ * Builders that can work in cell space write here directly. Only the region being rendered is ever
+ * expanded into wall glyphs with expand_passage_region.
+ */
+class Passage_maze
+{
+public:
+  using Passage_word = uint64_t;
+
+  struct Cell
+  {
+    uint64_t row;
+    uint64_t col;
+  };
+
+  // Uses the same odd square dimensions as a Maze so the two are interchangeable in run settings.
+  explicit Passage_maze( const Maze::Maze_args& args );
+
+  uint64_t cell_rows() const;
+  uint64_t cell_cols() const;
+  uint64_t row_size() const;
+  uint64_t col_size() const;
+
+  bool is_east_open( const Cell& c ) const
+  {
+    return ( passages_[word_index( c )] >> shift( c ) ) & east_passage_;
+  }
+
+  bool is_south_open( const Cell& c ) const
+  {
+    return ( passages_[word_index( c )] >> shift( c ) ) & south_passage_;
+  }
+
+  void open_east( const Cell& c )
+  {
+    passages_[word_index( c )] |= east_passage_ << shift( c );
+  }
+
+  void open_south( const Cell& c )
+  {
+    passages_[word_index( c )] |= south_passage_ << shift( c );
+  }
+
+  bool has_passage( const Cell& c ) const;
+  void join_cells( const Cell& cur, const Cell& next );
+  // The packed passage words in cell order, ready to be written out as is.
+  std::span<const Passage_word> words() const;
+
+  static constexpr Passage_word east_passage_ = 0b01;
+  static constexpr Passage_word south_passage_ = 0b10;
+  static constexpr uint64_t passage_bits_ = 2;
+  static constexpr uint64_t cells_per_word_ = 32;
+
+private:
+  uint64_t cell_rows_;
+  uint64_t cell_cols_;
+  std::vector<Passage_word> passages_;
+
+  uint64_t word_index( const Cell& c ) const
+  {
+    return ( ( c.row * cell_cols_ ) + c.col ) / cells_per_word_;
+  }
+
+  uint64_t shift( const Cell& c ) const
+  {
+    return ( ( ( c.row * cell_cols_ ) + c.col ) % cells_per_word_ ) * passage_bits_;
+  }
+};
+
+/* Fills every square of the window Maze with the squares of the full grid starting at origin. Wall
+ * glyphs are computed from the full grid so a window edge never draws a false wall connection.
+ */
+void expand_passage_region( const Passage_maze& passages, Maze& window, const Maze::Point& origin );
+
+} // namespace Builder
+
+#endif
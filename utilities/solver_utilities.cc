@@ -1,78 +1,178 @@
-#include "solver_utilities.hh"
+#include "maze_random.hh"
 #include "print_utilities.hh"
+#include "solver_utilities.hh"
 
 #include <iostream>
-#include <random>
 
 namespace Solver {
 
 namespace {
 
-bool is_valid_start_or_finish( const Builder::Maze& maze, const Builder::Maze::Point& choice )
+/* Every helper that accepts a view shares its body with the Maze version. Views index exactly like
+ * the maze so either one works as the Grid.
+ */
+template<typename Grid>
+bool is_valid_start_or_finish_in( const Grid& maze, const Builder::Maze::Point& choice )
 {
   return choice.row > 0 && choice.row < maze.row_size() - 1 && choice.col > 0 && choice.col < maze.col_size() - 1
          && ( maze[choice.row][choice.col] & Builder::Maze::path_bit_ )
          && !( maze[choice.row][choice.col] & finish_bit_ ) && !( maze[choice.row][choice.col] & start_bit_ );
 }
 
-} // namespace
-
-std::vector<Builder::Maze::Point> set_corner_starts( const Builder::Maze& maze )
+template<typename Grid>
+void print_point_in( const Grid& maze, const Builder::Maze::Point& point )
 {
-  Builder::Maze::Point point1 = { 1, 1 };
-  if ( !( maze[point1.row][point1.col] & Builder::Maze::path_bit_ ) ) {
-    point1 = find_nearest_square( maze, point1 );
+  const Builder::Maze::Square square = maze[point.row][point.col];
+  if ( square & finish_bit_ ) {
+    std::cout << ansi_finish_;
+    return;
   }
-  Builder::Maze::Point point2 = { 1, maze.col_size() - 2 };
-  if ( !( maze[point2.row][point2.col] & Builder::Maze::path_bit_ ) ) {
-    point2 = find_nearest_square( maze, point2 );
+  if ( square & start_bit_ ) {
+    std::cout << ansi_start_;
+    return;
   }
-  Builder::Maze::Point point3 = { maze.row_size() - 2, 1 };
-  if ( !( maze[point3.row][point3.col] & Builder::Maze::path_bit_ ) ) {
-    point3 = find_nearest_square( maze, point3 );
+  if ( square & thread_mask_ ) {
+    const Thread_paint thread_color = static_cast<Thread_paint>( square & thread_mask_ ) >> thread_tag_offset_;
+    std::cout << thread_colors_.at( thread_color );
+    return;
   }
-  Builder::Maze::Point point4 = { maze.row_size() - 2, maze.col_size() - 2 };
-  if ( !( maze[point4.row][point4.col] & Builder::Maze::path_bit_ ) ) {
-    point4 = find_nearest_square( maze, point4 );
+  if ( !( square & Builder::Maze::path_bit_ ) ) {
+    std::cout << maze.wall_style().at( square & Builder::Maze::wall_mask_ );
+    return;
   }
-  return { point1, point2, point3, point4 };
+  if ( square & Builder::Maze::path_bit_ ) {
+    std::cout << " ";
+    return;
+  }
+  std::cerr << "Printed maze and a square was not categorized." << std::endl;
+  abort();
 }
 
-Builder::Maze::Point pick_random_point( const Builder::Maze& maze )
+template<typename Grid>
+void print_maze_in( const Grid& maze )
 {
-  std::mt19937 generator( std::random_device {}() );
-  std::uniform_int_distribution<int> row_random( 1, maze.row_size() - 2 );
-  std::uniform_int_distribution<int> col_random( 1, maze.col_size() - 2 );
-  Builder::Maze::Point choice = { row_random( generator ), col_random( generator ) };
-  if ( !is_valid_start_or_finish( maze, choice ) ) {
-    choice = find_nearest_square( maze, choice );
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+      print_point_in( maze, { row, col } );
+    }
+    std::cout << "\n";
   }
-  return choice;
+  std::cout << std::flush;
 }
 
-Builder::Maze::Point find_nearest_square( const Builder::Maze& maze, const Builder::Maze::Point& choice )
+template<typename Grid>
+Builder::Maze::Point find_nearest_square_in( const Grid& maze, const Builder::Maze::Point& choice )
 {
   // Fanning out from a starting point should work on any medium to large maze.
   for ( const Builder::Maze::Point& p : all_directions_ ) {
     const Builder::Maze::Point next = { choice.row + p.row, choice.col + p.col };
-    if ( is_valid_start_or_finish( maze, next ) ) {
+    if ( is_valid_start_or_finish_in( maze, next ) ) {
       return next;
     }
   }
   // Getting desperate here. We should only need this for very small mazes.
-  for ( int row = 1; row < maze.row_size() - 1; row++ ) {
-    for ( int col = 1; col < maze.col_size() - 1; col++ ) {
-      if ( is_valid_start_or_finish( maze, { row, col } ) ) {
+  for ( int64_t row = 1; row < maze.row_size() - 1; row++ ) {
+    for ( int64_t col = 1; col < maze.col_size() - 1; col++ ) {
+      if ( is_valid_start_or_finish_in( maze, { row, col } ) ) {
         return { row, col };
       }
     }
   }
   std::cerr << "Could not place a point. Bad point = "
             << "{" << choice.row << "," << choice.col << "}" << std::endl;
-  print_maze( maze );
+  print_maze_in( maze );
   std::abort();
 }
 
+template<typename Grid>
+std::vector<Builder::Maze::Point> set_corner_starts_in( const Grid& maze )
+{
+  Builder::Maze::Point point1 = { 1, 1 };
+  if ( !( maze[point1.row][point1.col] & Builder::Maze::path_bit_ ) ) {
+    point1 = find_nearest_square_in( maze, point1 );
+  }
+  Builder::Maze::Point point2 = { 1, maze.col_size() - 2 };
+  if ( !( maze[point2.row][point2.col] & Builder::Maze::path_bit_ ) ) {
+    point2 = find_nearest_square_in( maze, point2 );
+  }
+  Builder::Maze::Point point3 = { maze.row_size() - 2, 1 };
+  if ( !( maze[point3.row][point3.col] & Builder::Maze::path_bit_ ) ) {
+    point3 = find_nearest_square_in( maze, point3 );
+  }
+  Builder::Maze::Point point4 = { maze.row_size() - 2, maze.col_size() - 2 };
+  if ( !( maze[point4.row][point4.col] & Builder::Maze::path_bit_ ) ) {
+    point4 = find_nearest_square_in( maze, point4 );
+  }
+  return { point1, point2, point3, point4 };
+}
+
+template<typename Grid>
+Builder::Maze::Point pick_random_point_in( const Grid& maze )
+{
+  Maze_random generator = make_maze_random();
+  Builder::Maze::Point choice
+    = { generator.between( 1, maze.row_size() - 2 ), generator.between( 1, maze.col_size() - 2 ) };
+  if ( !is_valid_start_or_finish_in( maze, choice ) ) {
+    choice = find_nearest_square_in( maze, choice );
+  }
+  return choice;
+}
+
+template<typename Grid>
+void clear_solver_marks_in( Grid& maze )
+{
+  const auto keep
+    = static_cast<Builder::Maze::Square>( ~( start_bit_ | finish_bit_ | thread_mask_ | cache_mask_ ) );
+  for ( int64_t row = 0; row < maze.row_size(); row++ ) {
+    for ( int64_t col = 0; col < maze.col_size(); col++ ) {
+      maze[row][col] &= keep;
+    }
+  }
+}
+
+} // namespace
+
+std::vector<Builder::Maze::Point> set_corner_starts( const Builder::Maze& maze )
+{
+  return set_corner_starts_in( maze );
+}
+
+std::vector<Builder::Maze::Point> set_corner_starts( const Builder::Const_maze_view& maze )
+{
+  return set_corner_starts_in( maze );
+}
+
+Builder::Maze::Point pick_random_point( const Builder::Maze& maze )
+{
+  return pick_random_point_in( maze );
+}
+
+Builder::Maze::Point pick_random_point( const Builder::Const_maze_view& maze )
+{
+  return pick_random_point_in( maze );
+}
+
+Builder::Maze::Point find_nearest_square( const Builder::Maze& maze, const Builder::Maze::Point& choice )
+{
+  return find_nearest_square_in( maze, choice );
+}
+
+Builder::Maze::Point find_nearest_square( const Builder::Const_maze_view& maze,
+                                          const Builder::Maze::Point& choice )
+{
+  return find_nearest_square_in( maze, choice );
+}
+
+void clear_solver_marks( Builder::Maze& maze )
+{
+  clear_solver_marks_in( maze );
+}
+
+void clear_solver_marks( const Builder::Maze_view& maze )
+{
+  clear_solver_marks_in( maze );
+}
+
 void clear_and_flush_paths( const Builder::Maze& maze )
 {
   Printer::clear_screen();
@@ -81,13 +181,13 @@ void clear_and_flush_paths( const Builder::Maze& maze )
 
 void print_maze( const Builder::Maze& maze )
 {
-  for ( int row = 0; row < maze.row_size(); row++ ) {
-    for ( int col = 0; col < maze.col_size(); col++ ) {
-      print_point( maze, { row, col } );
-    }
-    std::cout << "\n";
-  }
-  std::cout << std::flush;
+  maze.advise( Builder::Maze::Access_pattern::sequential );
+  print_maze_in( maze );
+}
+
+void print_maze( const Builder::Const_maze_view& maze )
+{
+  print_maze_in( maze );
 }
 
 void flush_cursor_path_coordinate( const Builder::Maze& maze, const Builder::Maze::Point& point )
@@ -99,30 +199,12 @@ void flush_cursor_path_coordinate( const Builder::Maze& maze, const Builder::Maz
 
 void print_point( const Builder::Maze& maze, const Builder::Maze::Point& point )
 {
-  const Builder::Maze::Square& square = maze[point.row][point.col];
-  if ( square & finish_bit_ ) {
-    std::cout << ansi_finish_;
-    return;
-  }
-  if ( square & start_bit_ ) {
-    std::cout << ansi_start_;
-    return;
-  }
-  if ( square & thread_mask_ ) {
-    const Thread_paint thread_color = static_cast<Thread_paint>( square & thread_mask_ ) >> thread_tag_offset_;
-    std::cout << thread_colors_.at( thread_color );
-    return;
-  }
-  if ( !( square & Builder::Maze::path_bit_ ) ) {
-    std::cout << maze.wall_style().at( square & Builder::Maze::wall_mask_ );
-    return;
-  }
-  if ( square & Builder::Maze::path_bit_ ) {
-    std::cout << " ";
-    return;
-  }
-  std::cerr << "Printed maze and a square was not categorized." << std::endl;
-  abort();
+  print_point_in( maze, point );
+}
+
+void print_point( const Builder::Const_maze_view& maze, const Builder::Maze::Point& point )
+{
+  print_point_in( maze, point );
 }
 
 void print_hunt_solution_message( std::optional<int> winning_index )
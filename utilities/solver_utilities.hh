@@ -2,6 +2,7 @@
 #ifndef SOLVER_UTILITIES_HH
 #define SOLVER_UTILITIES_HH
 #include "maze.hh"
+#include "maze_view.hh"
 #include <array>
 #include <optional>
 #include <string_view>
@@ -65,12 +66,24 @@ Builder::Maze::Point pick_random_point( const Builder::Maze& maze );
 Builder::Maze::Point find_nearest_square( const Builder::Maze& maze, const Builder::Maze::Point& choice );
 void print_point( const Builder::Maze& maze, const Builder::Maze::Point& point );
 void print_maze( const Builder::Maze& maze );
+
+// The same helpers for a window of a maze. Points are relative to the view origin.
+std::vector<Builder::Maze::Point> set_corner_starts( const Builder::Const_maze_view& maze );
+Builder::Maze::Point pick_random_point( const Builder::Const_maze_view& maze );
+Builder::Maze::Point find_nearest_square( const Builder::Const_maze_view& maze,
+                                          const Builder::Maze::Point& choice );
+void print_point( const Builder::Const_maze_view& maze, const Builder::Maze::Point& point );
+void print_maze( const Builder::Const_maze_view& maze );
 void flush_cursor_path_coordinate( const Builder::Maze& maze, const Builder::Maze::Point& point );
 void clear_and_flush_paths( const Builder::Maze& maze );
 void print_hunt_solution_message( std::optional<int> winning_index );
 void print_gather_solution_message();
 void print_overlap_key();
 
+// A maze reused from a mapped file still carries the start, finish, and thread bits of its last solve.
+void clear_solver_marks( Builder::Maze& maze );
+void clear_solver_marks( const Builder::Maze_view& maze );
+
 /* * * * * * * * * * * * *     Helpful Read-Only Data Available to All Solvers   * * * * * * * * * * * * * * * * */
 
 constexpr Thread_paint start_bit_ = 0b0100'0000'0000'0000;